@@ -0,0 +1,127 @@
+#include "BlobExtractor.hpp"
+
+#include <algorithm>
+
+
+hand::BlobExtractor::BlobExtractor(int minArea, int maxArea, bool tracking) :
+    m_minArea(minArea), m_maxArea(maxArea), m_tracking(tracking)
+{}
+
+
+void hand::BlobExtractor::setAreaRange(int minArea, int maxArea) {
+    m_minArea = minArea;
+    m_maxArea = maxArea;
+}
+
+
+void hand::BlobExtractor::setTracking(bool tracking) {
+    m_tracking = tracking;
+}
+
+
+const hand::Blob& hand::BlobExtractor::extract(const cv::Mat& mask) {
+    CV_Assert(mask.type() == CV_8U);
+    const cv::Rect frame(0, 0, mask.cols, mask.rows);
+
+    if (m_tracking && m_blob.found) {
+        int mx = (int)(m_blob.box.width * BLOB_SEARCH_MARGIN);
+        int my = (int)(m_blob.box.height * BLOB_SEARCH_MARGIN);
+        cv::Rect window = cv::Rect(m_blob.box.x - mx, m_blob.box.y - my,
+                                   m_blob.box.width + 2 * mx, m_blob.box.height + 2 * my) & frame;
+
+        if (window != frame) {
+            m_stats.windowSearches++;
+            if (search(mask, window)) {
+                /*
+                A blob touching an inner border of the window may be cut, label everything again.
+                */
+                const cv::Rect& box = m_blob.box;
+                bool cut = (box.x == window.x && window.x > 0) ||
+                           (box.y == window.y && window.y > 0) ||
+                           (box.br().x == window.br().x && window.br().x < frame.width) ||
+                           (box.br().y == window.br().y && window.br().y < frame.height);
+                if (cut == false)
+                    return m_blob;
+            }
+            m_stats.fallbacks++;
+        }
+    }
+
+    m_stats.fullSearches++;
+    search(mask, frame);
+    return m_blob;
+}
+
+
+const hand::Blob& hand::BlobExtractor::getBlob() const {
+    return m_blob;
+}
+
+
+void hand::BlobExtractor::reset() {
+    m_blob.found = false;
+}
+
+
+hand::BlobStats hand::BlobExtractor::getStats() const {
+    return m_stats;
+}
+
+//-------------------Private methods start here-------------------
+
+bool hand::BlobExtractor::search(const cv::Mat& mask, const cv::Rect& window) {
+    int count = cv::connectedComponentsWithStats(mask(window), m_labels, m_componentStats, m_centroids, 8, CV_32S);
+    m_stats.components += count - 1;
+
+    /*
+    Area filter on the stats, label 0 is the background
+    */
+    int best = -1;
+    int bestArea = m_minArea;
+    for (int i = 1; i < count; ++i) {
+        int area = m_componentStats.at<int>(i, cv::CC_STAT_AREA);
+        if (area > bestArea && (m_maxArea <= 0 || area <= m_maxArea)) {
+            bestArea = area;
+            best = i;
+        }
+    }
+
+    if (best < 0) {
+        m_blob.found = false;
+        m_blob.area = 0;
+        m_blob.box = cv::Rect();
+        m_blob.contour.clear();
+        return false;
+    }
+
+    m_blob.found = true;
+    m_blob.area = bestArea;
+    m_blob.box = cv::Rect(m_componentStats.at<int>(best, cv::CC_STAT_LEFT) + window.x,
+                          m_componentStats.at<int>(best, cv::CC_STAT_TOP) + window.y,
+                          m_componentStats.at<int>(best, cv::CC_STAT_WIDTH),
+                          m_componentStats.at<int>(best, cv::CC_STAT_HEIGHT));
+    m_blob.centroid = cv::Point2d(m_centroids.at<double>(best, 0) + window.x,
+                                  m_centroids.at<double>(best, 1) + window.y);
+    trace(window, best);
+    return true;
+}
+
+
+void hand::BlobExtractor::trace(const cv::Rect& window, int label) {
+    /*
+    Only the bounding box of the winner is traced, other components inside it are masked out.
+    */
+    cv::Rect box = m_blob.box - window.tl();
+    cv::compare(m_labels(box), cv::Scalar(label), m_component, cv::CMP_EQ);
+    cv::findContours(m_component, m_contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE, m_blob.box.tl());
+
+    /*
+    One 8-connected component has one external contour
+    */
+    auto longest = std::max_element(m_contours.begin(), m_contours.end(),
+        [](const std::vector<cv::Point>& a, const std::vector<cv::Point>& b) { return a.size() < b.size(); });
+    if (longest != m_contours.end())
+        m_blob.contour.assign(longest->begin(), longest->end());
+    else
+        m_blob.contour.clear();
+}
@@ -0,0 +1,108 @@
+#ifndef BLOBEXTRACTOR_H
+#define BLOBEXTRACTOR_H
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#define BLOB_SEARCH_MARGIN  0.5f  // Tracking window = last blob box grown by this fraction per side
+
+namespace hand {
+
+    /*
+    Largest blob of a mask.
+    Attributes:
+        found: a component passed the area filter, other fields are empty otherwise
+        area: pixel count of the component
+        box: bounding box in mask coordinates
+        centroid: in mask coordinates
+        contour: external contour of the component, in mask coordinates
+    */
+    struct Blob {
+        bool found = false;
+        int area = 0;
+        cv::Rect box;
+        cv::Point2d centroid;
+        std::vector<cv::Point> contour;
+    };
+
+    /*
+    Counters of a BlobExtractor.
+    Attributes:
+        fullSearches: labelling passes over the whole mask
+        windowSearches: labelling passes restricted to the tracking window
+        fallbacks: window searches that had to be redone on the whole mask
+        components: components labelled, over all passes
+    */
+    struct BlobStats {
+        size_t fullSearches = 0;
+        size_t windowSearches = 0;
+        size_t fallbacks = 0;
+        size_t components = 0;
+    };
+
+    /*
+    Find the largest blob of a binary mask without tracing every contour:
+    one connectedComponentsWithStats pass gives the area and box of each
+    component, the area filter picks the winner from the stats, and only the
+    winner is traced (findContours on its own bounding box).
+    With tracking enabled, the labelling runs in a window around the last
+    blob, and falls back to the whole mask when nothing is found there or
+    when the blob reaches the border of the window (it may continue outside).
+    */
+    class BlobExtractor {
+        public:
+            /*
+            Parameters:
+                minArea, maxArea: accepted component area (pixels), maxArea 0 for no limit
+                tracking: search around the previous blob first
+            */
+            BlobExtractor(int minArea = 1000, int maxArea = 0, bool tracking = false);
+
+            void setAreaRange(int minArea, int maxArea = 0);
+            void setTracking(bool tracking);
+
+            /*
+            Largest blob of mask (CV_8U, non zero = foreground).
+            The returned blob is reused by the next call.
+            */
+            const Blob& extract(const cv::Mat& mask);
+
+            const Blob& getBlob() const;
+
+            /*
+            Forget the previous blob, the next extract() searches the whole mask.
+            */
+            void reset();
+
+            BlobStats getStats() const;
+
+        private:
+            /*
+            Label window of mask, keep the largest accepted component.
+            Return false if there is none.
+            */
+            bool search(const cv::Mat& mask, const cv::Rect& window);
+            void trace(const cv::Rect& window, int label);
+
+        private:
+            int m_minArea;
+            int m_maxArea;
+            bool m_tracking;
+
+            Blob m_blob;
+            BlobStats m_stats;
+
+            /*
+            Buffers reused between frames
+            */
+            cv::Mat m_labels;
+            cv::Mat m_componentStats;
+            cv::Mat m_centroids;
+            cv::Mat m_component;
+            std::vector<std::vector<cv::Point>> m_contours;
+    };
+}
+
+#endif // BLOBEXTRACTOR_H
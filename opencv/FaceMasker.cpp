@@ -0,0 +1,239 @@
+#include "FaceMasker.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#define FACE_MIN_SIZE   30    // Smallest face at full resolution (pixels)
+
+/*
+Which cascade found a face, a tracked face is searched again with the same one
+*/
+#define FACE_FRONTAL        0
+#define FACE_PROFILE        1
+#define FACE_PROFILE_FLIP   2
+
+
+hand::FaceMasker::FaceMasker(const std::string& frontalPath, const std::string& profilePath, int detectInterval) :
+    m_hasProfile(false), m_nextPass(FACE_FRONTAL),
+    m_detectInterval(std::max(detectInterval, 1)), m_framesSinceDetection(0), m_forceDetection(true),
+    m_scale(1.0)
+{
+    if (m_frontal.load(frontalPath) == false)
+        std::cerr << "Fail to load face cascade: " << frontalPath << std::endl;
+
+    if (profilePath.empty() == false) {
+        m_hasProfile = m_profile.load(profilePath);
+        if (m_hasProfile == false)
+            std::cerr << "Fail to load profile cascade: " << profilePath << std::endl;
+    }
+}
+
+
+hand::FaceMasker::FaceMasker(Detector detector, int detectInterval) :
+    m_detector(std::move(detector)), m_hasProfile(false), m_nextPass(FACE_FRONTAL),
+    m_detectInterval(std::max(detectInterval, 1)), m_framesSinceDetection(0), m_forceDetection(true),
+    m_scale(1.0)
+{}
+
+
+bool hand::FaceMasker::isLoaded() const {
+    return m_detector || m_frontal.empty() == false;
+}
+
+
+const std::vector<cv::Rect>& hand::FaceMasker::update(const cv::Mat& img) {
+    m_stats.frames++;
+
+    if (m_detector) {
+        if (m_forceDetection || ++m_framesSinceDetection >= m_detectInterval) {
+            m_stats.fullDetections++;
+            m_framesSinceDetection = 0;
+            m_forceDetection = false;
+
+            cv::Rect frameRect(0, 0, img.cols, img.rows);
+            m_faces = m_detector(img);
+            for (auto& face : m_faces) {
+                face &= frameRect;
+            }
+        }
+        return m_faces;
+    }
+
+    m_scale = std::min(1.0, (double)FACE_DETECT_WIDTH / img.cols);
+    if (m_scale < 1.0)
+        cv::resize(img, m_small, cv::Size(), m_scale, m_scale, cv::INTER_AREA);
+    else
+        m_small = img;
+    cv::cvtColor(m_small, m_gray, cv::COLOR_BGR2GRAY);
+
+    /*
+    An empty scene is searched more often, but still not on every frame
+    */
+    int interval = m_tracked.empty() ? std::min(m_detectInterval, FACE_SEARCH_INTERVAL) : m_detectInterval;
+    bool fullDetection = m_forceDetection || ++m_framesSinceDetection >= interval;
+    if (fullDetection) {
+        if (m_forceDetection && m_tracked.empty() == false)
+            m_stats.resyncs++;
+        detectFull(m_gray);
+    }
+    else {
+        for (auto& face : m_tracked) {
+            if (searchAround(m_gray, face))
+                continue;
+
+            /*
+            Keep masking the last box for a few frames, then look everywhere again.
+            */
+            if (++face.misses > FACE_MAX_MISSES)
+                m_forceDetection = true;
+        }
+    }
+
+    cv::Rect frameRect(0, 0, img.cols, img.rows);
+    m_faces.clear();
+    for (const auto& face : m_tracked) {
+        cv::Rect box(cvRound(face.box.x / m_scale), cvRound(face.box.y / m_scale),
+                     cvRound(face.box.width / m_scale), cvRound(face.box.height / m_scale));
+        m_faces.push_back(box & frameRect);
+    }
+    return m_faces;
+}
+
+
+void hand::FaceMasker::mask(cv::Mat& img) const {
+    for (const cv::Rect& r : m_faces) {
+        cv::rectangle(img, r, cv::Scalar(0, 0, 0), cv::FILLED);
+    }
+}
+
+
+void hand::FaceMasker::apply(cv::Mat& img) {
+    update(img);
+    mask(img);
+}
+
+
+const std::vector<cv::Rect>& hand::FaceMasker::getFaces() const {
+    return m_faces;
+}
+
+
+hand::FaceMaskerStats hand::FaceMasker::getStats() const {
+    return m_stats;
+}
+
+//-------------------Private methods start here-------------------
+
+void hand::FaceMasker::detectFull(const cv::Mat& gray) {
+    m_stats.fullDetections++;
+    m_framesSinceDetection = 0;
+    m_forceDetection = false;
+
+    /*
+    One cascade per detection. The profile cascade only knows one side:
+    the other one is found on the mirrored frame, on another detection.
+    */
+    int kind = m_nextPass;
+    if (m_hasProfile)
+        m_nextPass = (m_nextPass + 1) % (FACE_PROFILE_FLIP + 1);
+
+    /*
+    This pass replaces the faces of its cascade, lost faces are dropped
+    */
+    m_tracked.erase(std::remove_if(m_tracked.begin(), m_tracked.end(), [kind](const TrackedFace& face) {
+        return face.kind == kind || face.misses > FACE_MAX_MISSES;
+    }), m_tracked.end());
+
+    cv::Mat equalized;
+    cv::equalizeHist(gray, equalized);
+
+    int minSide = std::max(cvRound(FACE_MIN_SIZE * m_scale), 12);
+    cv::Size minSize(minSide, minSide);
+
+    if (kind == FACE_FRONTAL) {
+        runCascade(m_frontal, equalized, m_found, minSize);
+    }
+    else if (kind == FACE_PROFILE) {
+        m_stats.profileDetections++;
+        runCascade(m_profile, equalized, m_found, minSize);
+    }
+    else {
+        m_stats.profileDetections++;
+        cv::Mat flipped;
+        cv::flip(equalized, flipped, 1);
+        runCascade(m_profile, flipped, m_found, minSize);
+        for (auto& r : m_found) {
+            r.x = equalized.cols - r.x - r.width;
+        }
+    }
+
+    for (const auto& r : m_found) {
+        /*
+        Already tracked through another cascade
+        */
+        bool tracked = std::any_of(m_tracked.begin(), m_tracked.end(), [&r](const TrackedFace& face) {
+            return (face.box & r).area() > 0;
+        });
+        if (tracked)
+            continue;
+
+        TrackedFace face;
+        face.box = r;
+        face.kind = kind;
+        m_tracked.push_back(face);
+    }
+}
+
+
+bool hand::FaceMasker::searchAround(const cv::Mat& gray, TrackedFace& face) {
+    m_stats.windowSearches++;
+
+    int mx = (int)(face.box.width * FACE_SEARCH_MARGIN);
+    int my = (int)(face.box.height * FACE_SEARCH_MARGIN);
+    cv::Rect window = cv::Rect(face.box.x - mx, face.box.y - my, face.box.width + 2 * mx, face.box.height + 2 * my)
+                    & cv::Rect(0, 0, gray.cols, gray.rows);
+    if (window.area() == 0)
+        return false;
+
+    cv::Mat roi;
+    cv::equalizeHist(gray(window), roi);
+    if (face.kind == FACE_PROFILE_FLIP)
+        cv::flip(roi, roi, 1);
+
+    /*
+    A face does not change size much from one frame to the next.
+    */
+    cv::Size minSize(cvRound(face.box.width / FACE_MAX_SCALE_CHANGE), cvRound(face.box.height / FACE_MAX_SCALE_CHANGE));
+    cv::Size maxSize(cvRound(face.box.width * FACE_MAX_SCALE_CHANGE), cvRound(face.box.height * FACE_MAX_SCALE_CHANGE));
+    runCascade(face.kind == FACE_FRONTAL ? m_frontal : m_profile, roi, m_found, minSize, maxSize);
+    if (m_found.empty())
+        return false;
+
+    if (face.kind == FACE_PROFILE_FLIP) {
+        for (auto& r : m_found) {
+            r.x = roi.cols - r.x - r.width;
+        }
+    }
+
+    /*
+    Keep the candidate closest to the previous position
+    */
+    cv::Point prevCenter = (face.box.tl() + face.box.br()) / 2 - window.tl();
+    auto distance = [&prevCenter](const cv::Rect& r) {
+        cv::Point d = (r.tl() + r.br()) / 2 - prevCenter;
+        return d.dot(d);
+    };
+    auto best = std::min_element(m_found.begin(), m_found.end(),
+        [&distance](const cv::Rect& a, const cv::Rect& b) { return distance(a) < distance(b); });
+
+    face.box = *best + window.tl();
+    face.misses = 0;
+    return true;
+}
+
+
+void hand::FaceMasker::runCascade(cv::CascadeClassifier& cascade, const cv::Mat& gray,
+                                  std::vector<cv::Rect>& out, cv::Size minSize, cv::Size maxSize) {
+    out.clear();
+    cascade.detectMultiScale(gray, out, 1.2, 5, 0, minSize, maxSize);
+}
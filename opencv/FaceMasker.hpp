@@ -0,0 +1,137 @@
+#ifndef FACEMASKER_H
+#define FACEMASKER_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/objdetect.hpp>
+
+#define FACE_DETECT_WIDTH       320   // Full detections run on a frame this wide
+#define FACE_DETECT_INTERVAL    10    // Frames between two full detections
+#define FACE_SEARCH_INTERVAL    3     // Frames between two full detections while no face is tracked
+#define FACE_SEARCH_MARGIN      0.5f  // Tracked search window = box grown by this fraction per side
+#define FACE_MAX_MISSES         3     // Tracking misses before a full detection is forced
+#define FACE_MAX_SCALE_CHANGE   1.5f  // Box size change between frames considered inconsistent
+
+namespace hand {
+
+    /*
+    Counters of a FaceMasker.
+    Attributes:
+        frames: frames given to update()
+        fullDetections: detections over the whole (downscaled) frame
+        profileDetections: full detections which ran the profile cascade
+        windowSearches: detections restricted to a window around a tracked face
+        resyncs: full detections forced by an inconsistent track
+    */
+    struct FaceMaskerStats {
+        size_t frames = 0;
+        size_t fullDetections = 0;
+        size_t profileDetections = 0;
+        size_t windowSearches = 0;
+        size_t resyncs = 0;
+    };
+
+    /*
+    Find faces to black them out before skin segmentation, much cheaper than
+    running detectMultiScale on every full resolution frame:
+      - detection runs on a frame downscaled to FACE_DETECT_WIDTH,
+      - the whole frame is searched only every FACE_DETECT_INTERVAL frames
+        (FACE_SEARCH_INTERVAL while no face is tracked), or when a tracked box
+        becomes inconsistent,
+      - in between, each face is searched only in a margin around its last box.
+    A full detection runs a single cascade: frontal, profile and mirrored profile
+    (optional) take turns, so a frame never pays for two of them. Faces found by
+    the other cascades keep being tracked meanwhile.
+
+    An external detector (e.g. hand::FaceDetection, BlazeFace on tflite) can
+    be used in place of the cascades.
+    */
+    class FaceMasker {
+        public:
+            /*
+            Find faces in a BGR frame, boxes in frame coordinates.
+            */
+            using Detector = std::function<std::vector<cv::Rect>(const cv::Mat& img)>;
+
+            /*
+            Parameters:
+                frontalPath: frontal face cascade (.xml)
+                profilePath: profile face cascade (.xml), empty to disable
+                detectInterval: frames between two full detections
+            */
+            FaceMasker(const std::string& frontalPath, const std::string& profilePath = "",
+                       int detectInterval = FACE_DETECT_INTERVAL);
+
+            /*
+            Use detector instead of the cascades. It sees the full frame every
+            detectInterval frames, the last boxes are masked in between.
+            */
+            FaceMasker(Detector detector, int detectInterval = 1);
+
+            /*
+            True if the frontal cascade has been loaded (or an external detector is used).
+            */
+            bool isLoaded() const;
+
+            /*
+            Find the faces of img (BGR). Boxes are in img coordinates.
+            */
+            const std::vector<cv::Rect>& update(const cv::Mat& img);
+
+            /*
+            Black out the faces found by the last update().
+            */
+            void mask(cv::Mat& img) const;
+
+            /*
+            update() then mask().
+            */
+            void apply(cv::Mat& img);
+
+            const std::vector<cv::Rect>& getFaces() const;
+
+            FaceMaskerStats getStats() const;
+
+        private:
+            struct TrackedFace {
+                cv::Rect box;   // In downscaled coordinates
+                int kind = 0;   // Cascade which found it
+                int misses = 0;
+            };
+
+            void detectFull(const cv::Mat& small);
+            bool searchAround(const cv::Mat& small, TrackedFace& face);
+            void runCascade(cv::CascadeClassifier& cascade, const cv::Mat& gray,
+                            std::vector<cv::Rect>& out, cv::Size minSize, cv::Size maxSize = cv::Size());
+
+        private:
+            Detector m_detector;
+            cv::CascadeClassifier m_frontal;
+            cv::CascadeClassifier m_profile;
+            bool m_hasProfile;
+            int m_nextPass;
+
+            int m_detectInterval;
+            int m_framesSinceDetection;
+            bool m_forceDetection;
+
+            double m_scale;
+            std::vector<TrackedFace> m_tracked;
+            std::vector<cv::Rect> m_faces;
+
+            /*
+            Buffers reused between frames
+            */
+            cv::Mat m_small;
+            cv::Mat m_gray;
+            std::vector<cv::Rect> m_found;
+
+            FaceMaskerStats m_stats;
+    };
+}
+
+#endif // FACEMASKER_H
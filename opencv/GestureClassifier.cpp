@@ -0,0 +1,169 @@
+#include "GestureClassifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+hand::GestureClassifier::GestureClassifier(const GestureOptions& options) {
+    setOptions(options);
+}
+
+
+void hand::GestureClassifier::setOptions(const GestureOptions& options) {
+    m_options = options;
+    m_blobs.setTracking(options.tracking);
+}
+
+
+const hand::GestureOptions& hand::GestureClassifier::getOptions() const {
+    return m_options;
+}
+
+
+const hand::GestureResult& hand::GestureClassifier::classify(const cv::Mat& mask, cv::Point offset) {
+    if (extractLargest(mask, 1.0) == false) {
+        clearResult();
+        return m_result;
+    }
+
+    for (auto& p : m_result.contour) {
+        p += offset;
+    }
+    analyze();
+    return m_result;
+}
+
+
+const hand::GestureResult& hand::GestureClassifier::classify(const cv::Mat& mask, const ProcessingPyramid& pyramid, cv::Point offset) {
+    const int scale = pyramid.getScale();
+    if (extractLargest(mask, 1.0 / (scale * scale)) == false) {
+        clearResult();
+        return m_result;
+    }
+
+    pyramid.toFull(m_result.contour);
+    for (auto& p : m_result.contour) {
+        p += offset;
+    }
+    analyze();
+    return m_result;
+}
+
+
+const hand::GestureResult& hand::GestureClassifier::classify(const std::vector<cv::Point>& contour) {
+    double area = cv::contourArea(contour);
+    if (area < m_options.minArea || (m_options.maxArea > 0 && area > m_options.maxArea)) {
+        clearResult();
+        return m_result;
+    }
+
+    m_result.contour.assign(contour.begin(), contour.end());
+    analyze();
+    return m_result;
+}
+
+
+const hand::GestureResult& hand::GestureClassifier::getResult() const {
+    return m_result;
+}
+
+
+hand::BlobStats hand::GestureClassifier::getBlobStats() const {
+    return m_blobs.getStats();
+}
+
+
+const char* hand::GestureClassifier::toString(Gesture gesture) {
+    switch (gesture) {
+        case Gesture::Fist:    return "Fist";
+        case Gesture::Two:     return "Two";
+        case Gesture::Three:   return "Three";
+        case Gesture::Four:    return "Four";
+        case Gesture::Five:    return "Five";
+        case Gesture::Unknown: return "Unknown";
+        default:               return "None";
+    }
+}
+
+//-------------------Private methods start here-------------------
+
+bool hand::GestureClassifier::extractLargest(const cv::Mat& mask, double areaScale) {
+    m_blobs.setAreaRange(cvRound(m_options.minArea * areaScale), cvRound(m_options.maxArea * areaScale));
+
+    const Blob& blob = m_blobs.extract(mask);
+    if (blob.found == false || blob.contour.size() < 3)
+        return false;
+
+    m_result.contour.assign(blob.contour.begin(), blob.contour.end());
+    return true;
+}
+
+
+void hand::GestureClassifier::analyze() {
+    const auto& contour = m_result.contour;
+
+    m_result.found = true;
+    m_result.area = cv::contourArea(contour);
+    m_result.box = cv::boundingRect(contour);
+    m_result.center = cv::Point(m_result.box.x + m_result.box.width / 2, m_result.box.y + m_result.box.height / 2);
+
+    m_result.hull.clear();
+    m_result.defects.clear();
+    m_result.tips.clear();
+    m_result.valleys.clear();
+
+    cv::convexHull(contour, m_hullIndices, false, false);
+    for (int i : m_hullIndices) {
+        m_result.hull.push_back(contour[i]);
+    }
+
+    if (m_hullIndices.size() > 3) {
+        cv::convexityDefects(contour, m_hullIndices, m_allDefects);
+    }
+    else {
+        m_allDefects.clear();
+    }
+
+    const float maxCos = std::cos(m_options.maxDefectAngle * (float)CV_PI / 180.f);
+    for (const cv::Vec4i& d : m_allDefects) {
+        if (d[3] / 256.f <= m_options.minDefectDepth)
+            continue;
+
+        const cv::Point& start = contour[d[0]];
+        const cv::Point& end = contour[d[1]];
+        const cv::Point& far = contour[d[2]];
+
+        if (m_options.maxDefectAngle < 180.f) {
+            cv::Point a = start - far;
+            cv::Point b = end - far;
+            double norm = std::sqrt((double)a.dot(a) * b.dot(b));
+            if (norm <= 0 || a.dot(b) / norm < maxCos)
+                continue;
+        }
+
+        m_result.defects.push_back(d);
+        m_result.tips.push_back(end);
+        m_result.valleys.push_back(far);
+    }
+
+    m_result.gaps = (int)m_result.defects.size();
+    if (m_result.gaps > 4)
+        m_result.gesture = Gesture::Unknown;
+    else
+        m_result.gesture = static_cast<Gesture>(m_result.gaps + (int)Gesture::Fist);
+}
+
+
+void hand::GestureClassifier::clearResult() {
+    m_result.found = false;
+    m_result.gesture = Gesture::None;
+    m_result.gaps = 0;
+    m_result.area = 0.0;
+    m_result.box = cv::Rect();
+    m_result.center = cv::Point();
+    m_result.contour.clear();
+    m_result.hull.clear();
+    m_result.defects.clear();
+    m_result.tips.clear();
+    m_result.valleys.clear();
+}
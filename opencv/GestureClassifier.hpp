@@ -0,0 +1,129 @@
+#ifndef GESTURECLASSIFIER_H
+#define GESTURECLASSIFIER_H
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "BlobExtractor.hpp"
+#include "ProcessingPyramid.hpp"
+
+namespace hand {
+
+    /*
+    Hand shape from the gaps between fingers.
+    Fist means no finger gap: a closed hand or a single finger.
+    Unknown means more gaps than a hand has (noisy contour).
+    */
+    enum class Gesture {
+        None = 0,   // No blob large enough
+        Fist,
+        Two,
+        Three,
+        Four,
+        Five,
+        Unknown     // More than 4 gaps
+    };
+
+    /*
+    Attributes:
+        minArea, maxArea: accepted blob area (full resolution pixels), maxArea 0 for no limit
+        minDefectDepth: a convexity defect deeper than this (pixels) is a gap between two fingers
+        maxDefectAngle: a gap must also be narrower than this (degrees), 180 to disable
+        tracking: look for the blob around the previous one first (see BlobExtractor)
+    */
+    struct GestureOptions {
+        double minArea = 1000.0;
+        double maxArea = 0.0;
+        float minDefectDepth = 20.f;
+        float maxDefectAngle = 180.f;
+        bool tracking = false;
+    };
+
+    /*
+    Result of GestureClassifier, in full resolution coordinates.
+    Attributes:
+        found: a blob passed the area filter, other fields are empty otherwise
+        gesture: shape from the number of gaps
+        gaps: convexity defects kept as finger gaps
+        area, box, center: of the largest blob
+        contour, hull: of the largest blob
+        defects: kept defects (indices in contour, depth * 256)
+        tips: end points of the kept defects
+        valleys: farthest points of the kept defects
+    */
+    struct GestureResult {
+        bool found = false;
+        Gesture gesture = Gesture::None;
+        int gaps = 0;
+        double area = 0.0;
+        cv::Rect box;
+        cv::Point center;
+        std::vector<cv::Point> contour;
+        std::vector<cv::Point> hull;
+        std::vector<cv::Vec4i> defects;
+        std::vector<cv::Point> tips;
+        std::vector<cv::Point> valleys;
+    };
+
+    /*
+    Count fingers from the convex hull and the convexity defects of the
+    largest blob of a binary mask.
+    The largest blob comes from a BlobExtractor (area filter on component
+    stats, only the winner is traced) and is the only one to get a hull and
+    defects. Every buffer (result included) is kept between frames, so a
+    frame does not allocate once the buffers have grown.
+    */
+    class GestureClassifier {
+        public:
+            GestureClassifier(const GestureOptions& options = GestureOptions());
+
+            void setOptions(const GestureOptions& options);
+            const GestureOptions& getOptions() const;
+
+            /*
+            Classify the largest blob of mask (CV_8U, non zero = hand).
+            offset is added to the result (e.g. the ROI position in the frame).
+            */
+            const GestureResult& classify(const cv::Mat& mask, cv::Point offset = cv::Point());
+
+            /*
+            Same with a mask at the processing level of pyramid: blobs are
+            compared at that level, only the winner is mapped back.
+            */
+            const GestureResult& classify(const cv::Mat& mask, const ProcessingPyramid& pyramid, cv::Point offset = cv::Point());
+
+            /*
+            Classify a contour found elsewhere (full resolution).
+            */
+            const GestureResult& classify(const std::vector<cv::Point>& contour);
+
+            const GestureResult& getResult() const;
+
+            static const char* toString(Gesture gesture);
+
+            BlobStats getBlobStats() const;
+
+        private:
+            /*
+            Largest blob of mask with the area filter scaled by areaScale, into m_result.contour
+            */
+            bool extractLargest(const cv::Mat& mask, double areaScale);
+            void analyze();
+            void clearResult();
+
+        private:
+            GestureOptions m_options;
+            GestureResult m_result;
+            BlobExtractor m_blobs;
+
+            /*
+            Buffers reused between frames
+            */
+            std::vector<int> m_hullIndices;
+            std::vector<cv::Vec4i> m_allDefects;
+    };
+}
+
+#endif // GESTURECLASSIFIER_H
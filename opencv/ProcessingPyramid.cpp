@@ -0,0 +1,168 @@
+#include "ProcessingPyramid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+hand::ProcessingPyramid::ProcessingPyramid(int level) {
+    setLevel(level);
+}
+
+
+void hand::ProcessingPyramid::setLevel(int level) {
+    m_level = std::max(0, std::min(level, PYRAMID_MAX_LEVEL));
+}
+
+
+int hand::ProcessingPyramid::getLevel() const {
+    return m_level;
+}
+
+
+int hand::ProcessingPyramid::getScale() const {
+    return 1 << m_level;
+}
+
+
+const cv::Mat& hand::ProcessingPyramid::down(const cv::Mat& img) {
+    if (m_level == 0)
+        return img;
+
+    /*
+    One INTER_AREA resize averages each scale x scale block,
+    cheaper than chaining pyrDown for every level.
+    */
+    cv::resize(img, m_small, cv::Size(img.cols / getScale(), img.rows / getScale()), 0, 0, cv::INTER_AREA);
+    return m_small;
+}
+
+
+int hand::ProcessingPyramid::scaleKernel(int ksize) const {
+    return scaleKernel(ksize, getScale());
+}
+
+
+int hand::ProcessingPyramid::scaleKernel(int ksize, int scale) {
+    return std::max(ksize / scale, 1) | 1;
+}
+
+
+void hand::ProcessingPyramid::findContours(const cv::Mat& mask, std::vector<std::vector<cv::Point>>& contours) const {
+    cv::findContours(mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+    toFull(contours);
+}
+
+
+void hand::ProcessingPyramid::toFull(std::vector<cv::Point>& points) const {
+    if (m_level == 0)
+        return;
+
+    /*
+    A pixel at the processing level covers a scale x scale block, use its center.
+    */
+    const int scale = getScale();
+    const int half = scale / 2;
+    for (auto& p : points) {
+        p.x = p.x * scale + half;
+        p.y = p.y * scale + half;
+    }
+}
+
+
+void hand::ProcessingPyramid::toFull(std::vector<std::vector<cv::Point>>& contours) const {
+    for (auto& contour : contours) {
+        toFull(contour);
+    }
+}
+
+
+void hand::ProcessingPyramid::toFull(std::vector<cv::Vec4i>& defects) const {
+    for (auto& d : defects) {
+        d[3] *= getScale();
+    }
+}
+
+
+cv::Rect hand::ProcessingPyramid::toFull(const cv::Rect& box) const {
+    const int scale = getScale();
+    return cv::Rect(box.x * scale, box.y * scale, box.width * scale, box.height * scale);
+}
+
+
+hand::PyramidAccuracy hand::ProcessingPyramid::checkAccuracy(const cv::Mat& img, const Segmenter& segment) {
+    PyramidAccuracy accuracy;
+
+    cv::Mat fullMask, mask;
+    std::vector<std::vector<cv::Point>> fullContours, contours;
+
+    segment(img, 1, fullMask);
+    cv::findContours(fullMask, fullContours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+    segment(down(img), getScale(), mask);
+    findContours(mask, contours);
+
+    int fullIdx = largestContour(fullContours);
+    int idx = largestContour(contours);
+    if (fullIdx < 0 || idx < 0)
+        return accuracy;
+
+    const auto& fullContour = fullContours[fullIdx];
+    const auto& contour = contours[idx];
+    accuracy.found = true;
+
+    /*
+    Overlap of the two filled contours, drawn at full resolution
+    */
+    cv::Mat fullFilled = cv::Mat::zeros(img.size(), CV_8U);
+    cv::Mat filled = cv::Mat::zeros(img.size(), CV_8U);
+    cv::drawContours(fullFilled, fullContours, fullIdx, cv::Scalar(255), cv::FILLED);
+    cv::drawContours(filled, contours, idx, cv::Scalar(255), cv::FILLED);
+
+    cv::Mat overlap;
+    cv::bitwise_and(fullFilled, filled, overlap);
+    int inter = cv::countNonZero(overlap);
+    cv::bitwise_or(fullFilled, filled, overlap);
+    int uni = cv::countNonZero(overlap);
+    accuracy.iou = uni > 0 ? (double)inter / uni : 0.0;
+
+    double fullArea = cv::contourArea(fullContour);
+    accuracy.areaError = std::abs(cv::contourArea(contour) - fullArea) / fullArea;
+
+    cv::Moments fm = cv::moments(fullContour);
+    cv::Moments m = cv::moments(contour);
+    if (fm.m00 > 0 && m.m00 > 0) {
+        accuracy.centroidOffset = std::hypot(fm.m10 / fm.m00 - m.m10 / m.m00, fm.m01 / fm.m00 - m.m01 / m.m00);
+    }
+
+    accuracy.fullDefects = countDefects(fullContour);
+    accuracy.defects = countDefects(contour);
+    return accuracy;
+}
+
+//-------------------Private methods start here-------------------
+
+int hand::ProcessingPyramid::largestContour(const std::vector<std::vector<cv::Point>>& contours) {
+    int maxIdx = -1;
+    double maxArea = PYRAMID_MIN_AREA;
+    for (size_t i = 0; i < contours.size(); ++i) {
+        double area = cv::contourArea(contours[i]);
+        if (area > maxArea) {
+            maxArea = area;
+            maxIdx = static_cast<int>(i);
+        }
+    }
+    return maxIdx;
+}
+
+
+int hand::ProcessingPyramid::countDefects(const std::vector<cv::Point>& contour) {
+    std::vector<int> hull;
+    std::vector<cv::Vec4i> defects;
+    cv::convexHull(contour, hull, false, false);
+    if (hull.size() < 3)
+        return 0;
+    cv::convexityDefects(contour, hull, defects);
+
+    return (int)std::count_if(defects.begin(), defects.end(),
+        [](const cv::Vec4i& d) { return d[3] / 256.f > PYRAMID_DEFECT_DEPTH; });
+}
@@ -0,0 +1,106 @@
+#ifndef PROCESSINGPYRAMID_H
+#define PROCESSINGPYRAMID_H
+
+#include <functional>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#define PYRAMID_MAX_LEVEL       2     // 1/4 resolution
+#define PYRAMID_MIN_AREA        1000  // Contours below this area (full resolution) are ignored by checkAccuracy()
+#define PYRAMID_DEFECT_DEPTH    20.f  // Defects deeper than this (full resolution pixels) are counted by checkAccuracy()
+
+namespace hand {
+
+    /*
+    Result of ProcessingPyramid::checkAccuracy(), largest contour at the
+    processing level compared to the one found at full resolution.
+    Attributes:
+        found: both resolutions found a contour
+        iou: intersection over union of the two filled contours
+        areaError: |area - fullArea| / fullArea
+        centroidOffset: distance between the two centroids (full resolution pixels)
+        defects, fullDefects: convexity defects deeper than PYRAMID_DEFECT_DEPTH
+    */
+    struct PyramidAccuracy {
+        bool found = false;
+        double iou = 0.0;
+        double areaError = 0.0;
+        double centroidOffset = 0.0;
+        int defects = 0;
+        int fullDefects = 0;
+    };
+
+    /*
+    Run segmentation and contour extraction of the classical pipelines on
+    a downscaled frame (level 1 = 1/2, level 2 = 1/4 resolution), and map
+    the results back to full resolution coordinates so that drawing, hulls
+    and defect depths stay in frame pixels.
+    Each pipeline owns its pyramid and picks its level, level 0 is a no-op.
+    */
+    class ProcessingPyramid {
+        public:
+            /*
+            Segment an image (BGR or gray) into a binary mask. img is downscaled
+            by scale, kernel sizes should go through scaleKernel(ksize, scale).
+            */
+            using Segmenter = std::function<void(const cv::Mat& img, int scale, cv::Mat& mask)>;
+
+            ProcessingPyramid(int level = 1);
+
+            /*
+            Clamped to [0, PYRAMID_MAX_LEVEL].
+            */
+            void setLevel(int level);
+            int getLevel() const;
+
+            /*
+            Downscale factor, 1 << level.
+            */
+            int getScale() const;
+
+            /*
+            img at the processing level (INTER_AREA). The returned image is
+            reused by the next call, and is img itself at level 0.
+            */
+            const cv::Mat& down(const cv::Mat& img);
+
+            /*
+            Odd kernel size covering the same area at the processing level as ksize at full resolution.
+            */
+            int scaleKernel(int ksize) const;
+            static int scaleKernel(int ksize, int scale);
+
+            /*
+            External contours of a mask at the processing level, in full resolution coordinates.
+            */
+            void findContours(const cv::Mat& mask, std::vector<std::vector<cv::Point>>& contours) const;
+
+            /*
+            Map results computed at the processing level back to full resolution.
+            Defect indices stay valid for the mapped contour, only the depth changes.
+            */
+            void toFull(std::vector<cv::Point>& points) const;
+            void toFull(std::vector<std::vector<cv::Point>>& contours) const;
+            void toFull(std::vector<cv::Vec4i>& defects) const;
+            cv::Rect toFull(const cv::Rect& box) const;
+
+            /*
+            Compare the largest contour found by segment on img at full
+            resolution and at the processing level.
+            It costs a full resolution pass, call it for validation only.
+            */
+            PyramidAccuracy checkAccuracy(const cv::Mat& img, const Segmenter& segment);
+
+        private:
+            static int largestContour(const std::vector<std::vector<cv::Point>>& contours);
+            static int countDefects(const std::vector<cv::Point>& contour);
+
+        private:
+            int m_level;
+            cv::Mat m_small;
+    };
+}
+
+#endif // PROCESSINGPYRAMID_H
@@ -0,0 +1,215 @@
+#include "SkinLut.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+#define SKIN_LUT_SHIFT  (8 - SKIN_LUT_BITS)
+#define SKIN_LUT_MASK   (SKIN_LUT_LEVELS - 1)
+
+
+hand::SkinLut::SkinLut() : m_table(SKIN_LUT_SIZE + 4, 0) {}
+
+
+hand::SkinLut hand::SkinLut::fromHsvRange(const cv::Scalar& lower, const cv::Scalar& upper) {
+    const int samples = SKIN_LUT_SAMPLES * SKIN_LUT_SAMPLES * SKIN_LUT_SAMPLES;
+    auto level = [](int cell, int sample) {
+        return (cell << SKIN_LUT_SHIFT) + ((2 * sample + 1) << SKIN_LUT_SHIFT) / (2 * SKIN_LUT_SAMPLES);
+    };
+
+    /*
+    One row per cell, holding colors spread evenly inside it,
+    converted with the same cvtColor as the inRange version.
+    */
+    cv::Mat colors(SKIN_LUT_SIZE, samples, CV_8UC3);
+    for (int i = 0; i < SKIN_LUT_SIZE; ++i) {
+        int b = i & SKIN_LUT_MASK;
+        int g = (i >> SKIN_LUT_BITS) & SKIN_LUT_MASK;
+        int r = i >> (2 * SKIN_LUT_BITS);
+
+        cv::Vec3b* row = colors.ptr<cv::Vec3b>(i);
+        for (int sb = 0; sb < SKIN_LUT_SAMPLES; ++sb) {
+            for (int sg = 0; sg < SKIN_LUT_SAMPLES; ++sg) {
+                for (int sr = 0; sr < SKIN_LUT_SAMPLES; ++sr) {
+                    *row++ = cv::Vec3b(level(b, sb), level(g, sg), level(r, sr));
+                }
+            }
+        }
+    }
+
+    cv::Mat hsv;
+    cv::cvtColor(colors, hsv, cv::COLOR_BGR2HSV);
+
+    bool hueWraps = lower[0] > upper[0];
+    auto inRange = [&](const cv::Vec3b& c) {
+        bool hue = hueWraps ? (c[0] >= lower[0] || c[0] <= upper[0])
+                            : (c[0] >= lower[0] && c[0] <= upper[0]);
+        return hue && c[1] >= lower[1] && c[1] <= upper[1] && c[2] >= lower[2] && c[2] <= upper[2];
+    };
+
+    SkinLut lut;
+    for (int i = 0; i < SKIN_LUT_SIZE; ++i) {
+        const cv::Vec3b* row = hsv.ptr<cv::Vec3b>(i);
+        int count = 0;
+        for (int n = 0; n < samples; ++n) {
+            count += inRange(row[n]);
+        }
+        lut.m_table[i] = (2 * count > samples) ? 255 : 0;
+    }
+    return lut;
+}
+
+
+void hand::SkinLut::addSamples(const cv::Mat& bgr, const cv::Mat& skinMask) {
+    CV_Assert(bgr.type() == CV_8UC3 && skinMask.type() == CV_8U && bgr.size() == skinMask.size());
+
+    if (m_totalCount.empty()) {
+        m_skinCount.assign(SKIN_LUT_SIZE, 0);
+        m_totalCount.assign(SKIN_LUT_SIZE, 0);
+    }
+
+    for (int y = 0; y < bgr.rows; ++y) {
+        const uchar* src = bgr.ptr<uchar>(y);
+        const uchar* label = skinMask.ptr<uchar>(y);
+        for (int x = 0; x < bgr.cols; ++x, src += 3) {
+            int i = indexOf(src[0], src[1], src[2]);
+            m_totalCount[i]++;
+            m_skinCount[i] += (label[x] != 0);
+        }
+    }
+}
+
+
+void hand::SkinLut::train(float minProbability, int minCount) {
+    if (m_totalCount.empty())
+        return;
+
+    for (int i = 0; i < SKIN_LUT_SIZE; ++i) {
+        uint32_t total = m_totalCount[i];
+        bool skin = total >= (uint32_t)std::max(minCount, 1) && m_skinCount[i] >= minProbability * total;
+        m_table[i] = skin ? 255 : 0;
+    }
+}
+
+
+void hand::SkinLut::classify(const cv::Mat& bgr, cv::Mat& mask) const {
+    CV_Assert(bgr.type() == CV_8UC3);
+    mask.create(bgr.size(), CV_8U);
+
+    cv::parallel_for_(cv::Range(0, bgr.rows), [&](const cv::Range& rows) {
+        classifyRows(bgr, mask, rows.start, rows.end);
+    });
+}
+
+
+void hand::SkinLut::clean(const cv::Mat& mask, cv::Mat& out, int ksize, int downscale) {
+    /*
+    A box average thresholded at half is a majority vote: it removes specks
+    (open) and fills holes (close) in one separable pass, whatever ksize.
+    */
+    if (downscale > 1) {
+        cv::Mat small;
+        cv::resize(mask, small, cv::Size(), 1.0 / downscale, 1.0 / downscale, cv::INTER_AREA);
+        int k = std::max(ksize / downscale, 1) | 1;
+        cv::blur(small, small, cv::Size(k, k));
+        cv::resize(small, out, mask.size(), 0, 0, cv::INTER_LINEAR);
+    }
+    else {
+        cv::blur(mask, out, cv::Size(ksize, ksize));
+    }
+    cv::threshold(out, out, 127, 255, cv::THRESH_BINARY);
+}
+
+
+void hand::SkinLut::apply(const cv::Mat& bgr, cv::Mat& mask, int ksize, int downscale) const {
+    classify(bgr, mask);
+    clean(mask, mask, ksize, downscale);
+}
+
+
+bool hand::SkinLut::isSkin(uchar b, uchar g, uchar r) const {
+    return m_table[indexOf(b, g, r)] != 0;
+}
+
+//-------------------Private methods start here-------------------
+
+int hand::SkinLut::indexOf(int b, int g, int r) {
+    return (b >> SKIN_LUT_SHIFT) | (g >> SKIN_LUT_SHIFT) << SKIN_LUT_BITS | (r >> SKIN_LUT_SHIFT) << (2 * SKIN_LUT_BITS);
+}
+
+
+void hand::SkinLut::classifyRows(const cv::Mat& bgr, cv::Mat& mask, int begin, int end) const {
+    const uchar* table = m_table.data();
+    const int cols = bgr.cols;
+
+    for (int y = begin; y < end; ++y) {
+        const uchar* src = bgr.ptr<uchar>(y);
+        uchar* dst = mask.ptr<uchar>(y);
+        int x = 0;
+
+#if defined(__AVX2__) && SKIN_LUT_BITS == 5
+        /*
+        8 pixels per step: each 128 bit half holds 4 BGR pixels, spread to
+        one pixel per 32 bit lane, indices computed in place, then gathered.
+        Each step reads 28 bytes from src.
+        */
+        const __m256i spread = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                                0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m256i narrow = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m256i maskB = _mm256_set1_epi32(0x001f);
+        const __m256i maskG = _mm256_set1_epi32(0x03e0);
+        const __m256i maskR = _mm256_set1_epi32(0x7c00);
+
+        for (; x + 10 <= cols; x += 8) {
+            const uchar* p = src + 3 * x;
+            __m128i lo = _mm_loadu_si128((const __m128i*)p);
+            __m128i hi = _mm_loadu_si128((const __m128i*)(p + 12));
+            __m256i px = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), spread);
+
+            // px = b | g << 8 | r << 16, keep the 5 high bits of each
+            __m256i index = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(px, 3), maskB),
+                            _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(px, 6), maskG),
+                                            _mm256_and_si256(_mm256_srli_epi32(px, 9), maskR)));
+
+            __m256i cells = _mm256_shuffle_epi8(_mm256_i32gather_epi32((const int*)table, index, 1), narrow);
+            uint32_t first = (uint32_t)_mm256_extract_epi32(cells, 0);
+            uint32_t second = (uint32_t)_mm256_extract_epi32(cells, 4);
+            std::memcpy(dst + x, &first, 4);
+            std::memcpy(dst + x + 4, &second, 4);
+        }
+#elif defined(__ARM_NEON) && SKIN_LUT_BITS == 5
+        /*
+        No gather on NEON: deinterleave and build 16 indices with vector ops,
+        then look them up.
+        */
+        for (; x + 16 <= cols; x += 16) {
+            uint8x16x3_t px = vld3q_u8(src + 3 * x);
+            uint8x16_t b = vshrq_n_u8(px.val[0], 3);
+            uint8x16_t g = vshrq_n_u8(px.val[1], 3);
+            uint8x16_t r = vshrq_n_u8(px.val[2], 3);
+
+            uint16_t index[16];
+            vst1q_u16(index, vorrq_u16(vmovl_u8(vget_low_u8(b)),
+                             vorrq_u16(vshlq_n_u16(vmovl_u8(vget_low_u8(g)), 5),
+                                       vshlq_n_u16(vmovl_u8(vget_low_u8(r)), 10))));
+            vst1q_u16(index + 8, vorrq_u16(vmovl_u8(vget_high_u8(b)),
+                                 vorrq_u16(vshlq_n_u16(vmovl_u8(vget_high_u8(g)), 5),
+                                           vshlq_n_u16(vmovl_u8(vget_high_u8(r)), 10))));
+            for (int i = 0; i < 16; ++i) {
+                dst[x + i] = table[index[i]];
+            }
+        }
+#endif
+
+        for (; x < cols; ++x) {
+            const uchar* p = src + 3 * x;
+            dst[x] = table[indexOf(p[0], p[1], p[2])];
+        }
+    }
+}
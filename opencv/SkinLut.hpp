@@ -0,0 +1,90 @@
+#ifndef SKINLUT_H
+#define SKINLUT_H
+
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#define SKIN_LUT_BITS       5     // Bits kept per channel, 32 levels
+#define SKIN_LUT_LEVELS     (1 << SKIN_LUT_BITS)
+#define SKIN_LUT_SIZE       (SKIN_LUT_LEVELS * SKIN_LUT_LEVELS * SKIN_LUT_LEVELS)  // 32 KB, fits in L1
+#define SKIN_LUT_SAMPLES    4     // Colors tested per channel and per cell when generated from HSV bounds
+#define SKIN_CLEAN_KSIZE    7     // Window of the majority filter, same reach as the 7x7 open/close
+
+namespace hand {
+
+    /*
+    Skin classifier mapping BGR straight to a mask through a quantized 3D table
+    (SKIN_LUT_BITS per channel). One pass over the frame replaces
+    cvtColor(HSV) + inRange, and clean() replaces the two elliptic morphology
+    passes with a separable majority filter, optionally on a downscaled mask.
+
+    The table is either generated from HSV bounds (same meaning as inRange
+    on a COLOR_BGR2HSV image) or trained from labelled frames.
+    classify() uses AVX2 gathers or NEON deinterleaving when compiled for them,
+    and splits the rows with cv::parallel_for_.
+    */
+    class SkinLut {
+        public:
+            /*
+            An empty table (everything is background).
+            */
+            SkinLut();
+
+            /*
+            Generate the table from HSV bounds, OpenCV 8 bit ranges (H in [0, 180]).
+            A cell is skin when most of the colors it holds are in range.
+            If lower[0] > upper[0] the hue range wraps around red.
+            */
+            static SkinLut fromHsvRange(const cv::Scalar& lower, const cv::Scalar& upper);
+
+            /*
+            Accumulate the colors of bgr, labelled by skinMask (non zero = skin).
+            */
+            void addSamples(const cv::Mat& bgr, const cv::Mat& skinMask);
+
+            /*
+            Build the table from the samples: a cell is skin when
+            P(skin | color) >= minProbability and it has been seen at least minCount times.
+            */
+            void train(float minProbability = 0.5f, int minCount = 1);
+
+            /*
+            Map bgr (CV_8UC3) to a mask (CV_8U, 0 or 255).
+            */
+            void classify(const cv::Mat& bgr, cv::Mat& mask) const;
+
+            /*
+            Remove specks and fill small holes: a pixel is kept if most of its
+            ksize x ksize neighbours are skin. With downscale > 1, the filter runs
+            on a mask downscaled by this factor (edges become smoother).
+            mask and out can be the same.
+            */
+            static void clean(const cv::Mat& mask, cv::Mat& out, int ksize = SKIN_CLEAN_KSIZE, int downscale = 1);
+
+            /*
+            classify() then clean().
+            */
+            void apply(const cv::Mat& bgr, cv::Mat& mask, int ksize = SKIN_CLEAN_KSIZE, int downscale = 1) const;
+
+            bool isSkin(uchar b, uchar g, uchar r) const;
+
+        private:
+            static int indexOf(int b, int g, int r);
+            void classifyRows(const cv::Mat& bgr, cv::Mat& mask, int begin, int end) const;
+
+        private:
+            /*
+            0 or 255 per cell, index = b | g << 5 | r << 10 (5 bits each).
+            Padded so that a 32 bit gather on the last cell stays inside.
+            */
+            std::vector<uchar> m_table;
+
+            std::vector<uint32_t> m_skinCount;
+            std::vector<uint32_t> m_totalCount;
+    };
+}
+
+#endif // SKINLUT_H
@@ -4,6 +4,8 @@
 #include <vector>
 #include <string>
 
+#include "GestureClassifier.hpp"
+
 // cv와 std 네임스페이스를 사용합니다.
 using namespace cv;
 using namespace std;
@@ -25,6 +27,12 @@ int main()
     // 관심 영역(ROI) 정의
     Rect roi_rect(340, 100, 270, 270);
 
+    // 최소 크기 1000, 깊이 40 이상인 결함만 손가락 사이로 카운트
+    hand::GestureOptions options;
+    options.minArea = 1000;
+    options.minDefectDepth = 40;
+    hand::GestureClassifier classifier(options);
+
     while (true)
     {
         // cap >> frame;
@@ -58,63 +66,34 @@ int main()
         blur(gray, blurred, Size(12, 12));
         threshold(blurred, thresholded, 0, 255, THRESH_BINARY_INV | THRESH_OTSU);
 
-        // 5. 윤곽선 찾기
-        vector<vector<Point>> contours;
-        findContours(thresholded, contours, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
-
-        if (!contours.empty())
+        // 5. 가장 큰 윤곽선만 볼록 껍질(Convex Hull)과 오목 결함(Convexity Defects) 계산
+        const hand::GestureResult& result = classifier.classify(thresholded);
+        if (result.found)
         {
-            // 가장 큰 윤곽선 찾기
-            double max_area = 0;
-            int max_contour_idx = -1;
-            for (size_t i = 0; i < contours.size(); i++)
+            for (const Point& far_pt : result.valleys)
             {
-                double area = contourArea(contours[i]);
-                if (area > max_area)
-                {
-                    max_area = area;
-                    max_contour_idx = i;
-                }
+                circle(roi, far_pt, 5, Scalar(0, 0, 255), -1); // 오목한 지점에 빨간 원 그리기
             }
 
-            // 가장 큰 윤곽선이 최소 크기(1000)를 넘을 경우 분석
-            if (max_area > 1000)
+            // 6. 텍스트 결정 및 출력
+            string text;
+            switch (result.gesture)
             {
-                vector<int> hull_indices;
-                vector<Vec4i> defects;
-
-                // 6. 볼록 껍질(Convex Hull)과 오목 결함(Convexity Defects) 계산
-                convexHull(contours[max_contour_idx], hull_indices, false);
-                convexityDefects(contours[max_contour_idx], hull_indices, defects);
-
-                int defect_count = 0;
-                for (const Vec4i& v : defects)
-                {
-                    float depth = v[3] / 256.0; // 결함 깊이
-                    if (depth > 40) // 깊이가 40 이상인 결함만 카운트
-                    {
-                        defect_count++;
-                        Point far_pt = contours[max_contour_idx][v[2]];
-                        circle(roi, far_pt, 5, Scalar(0, 0, 255), -1); // 오목한 지점에 빨간 원 그리기
-                    }
-                }
-
-                // 7. 텍스트 결정 및 출력
-                string text;
-                if (defect_count == 1) text = "Hi, This is 2";
-                else if (defect_count == 2) text = "This is 3";
-                else if (defect_count == 3) text = "Fantastic 4";
-                else if (defect_count == 4) text = "It's 5";
-                else text = "Jarvis is busy :P";
-                
-                putText(frame, text, Point(50, 50), FONT_HERSHEY_SIMPLEX, 1.5, Scalar(0, 0, 255), 3);
+                case hand::Gesture::Two:   text = "Hi, This is 2"; break;
+                case hand::Gesture::Three: text = "This is 3"; break;
+                case hand::Gesture::Four:  text = "Fantastic 4"; break;
+                case hand::Gesture::Five:  text = "It's 5"; break;
+                case hand::Gesture::Unknown: // 간격이 5개 이상 (노이즈 윤곽선)
+                default:                   text = "Jarvis is busy :P"; break;
             }
+
+            putText(frame, text, Point(50, 50), FONT_HERSHEY_SIMPLEX, 1.5, Scalar(0, 0, 255), 3);
         }
         
         // 전체 프레임에 ROI 영역 표시
         rectangle(frame, roi_rect, Scalar(0, 255, 255), 2);
         
-        // 8. 결과 보여주기
+        // 7. 결과 보여주기
         imshow("Gesture Recognition", frame);
         // 디버깅용 흑백 이미지 창
         imshow("Thresholded", thresholded);
@@ -1,64 +1,39 @@
 #include <opencv2/opencv.hpp>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <future>
 #include <iostream>
 #include <iomanip>
+#include <mutex>
 #include <sstream>
+#include <thread>
+
+#include "BlobExtractor.hpp"
+#include "FaceMasker.hpp"
+#include "ProcessingPyramid.hpp"
+#include "SkinLut.hpp"
+
+#ifdef USE_BLAZEFACE
+    #include "FaceDetection.hpp"
+#endif
 
 cv::Rect roiBox(200, 100, 300, 300); // 초기 ROI
 cv::Point prevCenter(-1, -1);       // 이전 중심점
 int swipeThreshold = 50;            // 스와이프 감지 민감도
 
-// 얼굴 영역 제거
-void removeFaceArea(cv::Mat& img, cv::CascadeClassifier& cascade) {
-    cv::Mat gray;
-    cv::cvtColor(img, gray, cv::COLOR_BGR2GRAY);
-    cv::equalizeHist(gray, gray);
-
-    std::vector<cv::Rect> faces;
-    cascade.detectMultiScale(gray, faces, 1.2, 5, 0, cv::Size(30, 30));
-
-    int height = img.rows;
-    for (const cv::Rect& r : faces) {
-        int cx = r.x + r.width / 2;
-        int cy = r.y + r.height / 2;
-        int w = r.width * 1.0;
-        int h = r.height * 1.0;
-        cv::rectangle(img,
-                      cv::Point(cx - w / 2, cy - h / 2),
-                      cv::Point(cx + w / 2, cy + h / 2),
-                      cv::Scalar(0, 0, 0), cv::FILLED);
-    }
-}
+#define PYRAMID_LEVEL (1)           // 마스크/윤곽선 처리 해상도 (0: 원본, 1: 1/2, 2: 1/4)
 
 // 손 피부색 기반으로 마스크 생성
-cv::Mat makeHandMask(const cv::Mat& img_bgr) {
-    cv::Mat img_hsv;
-    cv::cvtColor(img_bgr, img_hsv, cv::COLOR_BGR2HSV);
-    cv::Scalar lower(0, 20, 70);
-    cv::Scalar upper(20, 180, 255);
-    cv::Mat mask;
-    cv::inRange(img_hsv, lower, upper, mask);
-
-    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(7, 7));
-    cv::morphologyEx(mask, mask, cv::MORPH_CLOSE, kernel);
-    cv::morphologyEx(mask, mask, cv::MORPH_OPEN, kernel);
+// HSV 범위로 만든 3D LUT로 BGR -> 마스크 한 번에 변환, 모폴로지 대신 다수결 필터
+cv::Mat makeHandMask(const cv::Mat& img_bgr, int ksize = SKIN_CLEAN_KSIZE) {
+    static const hand::SkinLut skinLut = hand::SkinLut::fromHsvRange(cv::Scalar(0, 20, 70), cv::Scalar(20, 180, 255));
 
+    cv::Mat mask;
+    skinLut.apply(img_bgr, mask, ksize);
     return mask;
 }
 
-int findLargestContour(const std::vector<std::vector<cv::Point>>& contours) {
-    int maxIdx = -1;
-    double maxArea = 0;
-    for (size_t i = 0; i < contours.size(); ++i) {
-        double area = cv::contourArea(contours[i]);
-        if (area > 1000 && area < 100000 && area > maxArea) {
-            maxArea = area;
-            maxIdx = static_cast<int>(i);
-        }
-    }
-    return maxIdx;
-}
-
 // Swipe 함수
 void detectSwipe(const cv::Point& center, const cv::Point& prevCenter, int threshold, cv::Mat& img) {
     if (prevCenter.x == -1) return;
@@ -69,27 +44,65 @@ void detectSwipe(const cv::Point& center, const cv::Point& prevCenter, int thres
     }
 }
 
-// FPS 표시
-void drawFPS(double fps, cv::Mat& img) {
+// 단계별 처리 시간 (ms, 지수 이동 평균)
+struct StageTimes {
+    double face = 0;    // 얼굴 검출 (별도 스레드, 스킨 마스크와 동시 실행)
+    double skin = 0;    // 축소 + 피부색 마스크 + 얼굴 영역 제거
+    double blob = 0;    // 가장 큰 blob 추출
+    double render = 0;  // 그리기 + 합치기 + imshow (렌더 스레드)
+    double frame = 0;   // 프레임 간격
+};
+
+void updateAverage(double& average, double ms) {
+    average = (average == 0) ? ms : average * 0.9 + ms * 0.1;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+// 단계별 시간 표시 (FPS 대신)
+void drawStageTimes(const StageTimes& times, cv::Mat& img) {
     std::ostringstream ss;
-    ss << std::fixed << std::setprecision(2) << fps;
-    cv::putText(img, "FPS: " + ss.str(), cv::Point(10, 30),
-                cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(0, 255, 0), 2);
+    ss << std::fixed << std::setprecision(1) << "FPS: " << (times.frame > 0 ? 1000.0 / times.frame : 0.0);
+    cv::putText(img, ss.str(), cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(0, 255, 0), 2);
+
+    ss.str("");
+    ss << "face " << times.face << " | skin " << times.skin << " | blob " << times.blob
+       << " | render " << times.render << " ms";
+    cv::putText(img, ss.str(), cv::Point(10, 60), cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 255, 0), 1);
+}
+
+// 축소 마스크에서 얼굴 영역 제거 (박스는 원본 좌표)
+void maskFaces(cv::Mat& mask, const std::vector<cv::Rect>& faces, int scale) {
+    cv::Rect bounds(0, 0, mask.cols, mask.rows);
+    for (const cv::Rect& face : faces) {
+        cv::Rect box(face.x / scale, face.y / scale, (face.width + scale - 1) / scale, (face.height + scale - 1) / scale);
+        mask(box & bounds).setTo(cv::Scalar(0));
+    }
 }
 
 // 이미지 합치기
 cv::Mat combineImages(const cv::Mat& img, const cv::Mat& mask) {
     cv::Mat mask_color, combined;
     cv::cvtColor(mask, mask_color, cv::COLOR_GRAY2BGR);
+    if (mask_color.size() != img.size())
+        cv::resize(mask_color, mask_color, img.size(), 0, 0, cv::INTER_NEAREST);
     cv::hconcat(img, mask_color, combined);
     return combined;
 }
 
 int main() {
-    cv::CascadeClassifier face_cascade;
-    std::string face_model = "haarcascade_frontalface_alt.xml";
+#ifdef USE_BLAZEFACE
+    // BlazeFace(tflite) 얼굴 검출, 머리 전체를 가리도록 박스 확대
+    hand::FaceDetection blazeFace("../tflite/models", 1);
+    hand::FaceMasker faceMasker([&blazeFace](const cv::Mat& img) { return blazeFace.detect(img, 1.6f); });
+#else
+    // 축소 영상에서 얼굴 검출, 검출 사이에는 이전 얼굴 주변만 탐색
+    hand::FaceMasker faceMasker("haarcascade_frontalface_alt.xml", "haarcascade_profileface.xml");
+#endif
 
-    if (!face_cascade.load(face_model)) {
+    if (!faceMasker.isLoaded()) {
         std::cerr << "얼굴 검출 모델 로딩 실패" << std::endl;
         return -1;
     }
@@ -100,44 +113,150 @@ int main() {
         return -1;
     }
 
-    cv::Mat frame;
-    while (true) {
+    // 축소 해상도에서 마스크/윤곽선 처리, 윤곽선은 원본 좌표로 복원
+    hand::ProcessingPyramid pyramid(PYRAMID_LEVEL);
+    auto segment = [](const cv::Mat& img, int scale, cv::Mat& mask) {
+        mask = makeHandMask(img, hand::ProcessingPyramid::scaleKernel(SKIN_CLEAN_KSIZE, scale));
+    };
+
+    // 면적 1000 ~ 100000 (원본 해상도 기준) 인 가장 큰 blob
+    int areaScale = pyramid.getScale() * pyramid.getScale();
+    hand::BlobExtractor blobs(1000 / areaScale, 100000 / areaScale, true);
+
+    // 렌더 스레드로 넘기는 결과 (최신 결과만 유지)
+    struct RenderJob {
+        cv::Mat frame;
+        cv::Mat mask;
+        std::vector<cv::Rect> faces;
+        std::vector<std::vector<cv::Point>> contours;
+        cv::Rect handROI;
+        StageTimes times;
+    };
+    std::mutex renderMutex;
+    std::condition_variable renderReady;
+    RenderJob renderJob;
+    bool hasRenderJob = false;
+    std::atomic<bool> quit(false);
+    std::atomic<bool> accuracyRequested(false);
+    std::atomic<double> renderMs(0.0);
+
+    // 그리기, 합치기, imshow/waitKey 는 렌더 스레드에서
+    std::thread renderer([&]() {
+        RenderJob job;
+        while (!quit) {
+            bool ready = false;
+            {
+                std::unique_lock<std::mutex> lock(renderMutex);
+                renderReady.wait_for(lock, std::chrono::milliseconds(10), [&] { return hasRenderJob; });
+                if (hasRenderJob) {
+                    std::swap(job, renderJob);
+                    hasRenderJob = false;
+                    ready = true;
+                }
+            }
+
+            if (ready) {
+                auto start = std::chrono::steady_clock::now();
+                cv::Mat img = job.frame.clone();
+                for (const cv::Rect& face : job.faces) {
+                    cv::rectangle(img, face, cv::Scalar(0, 0, 0), cv::FILLED);
+                }
+                if (job.contours.empty() == false) {
+                    cv::drawContours(img, job.contours, 0, cv::Scalar(0, 255, 255), 2);
+                    rectangle(img, job.handROI, cv::Scalar(0, 255, 0), 2);
+
+                    cv::Point center(job.handROI.x + job.handROI.width / 2, job.handROI.y + job.handROI.height / 2);
+                    circle(img, center, 5, cv::Scalar(255, 255, 0), cv::FILLED);
+                }
+
+                drawStageTimes(job.times, img);
+                cv::Mat combined = combineImages(img, job.mask);
+                cv::imshow("Hand Detection (Original + Mask)", combined);
+                renderMs = elapsedMs(start);
+            }
+
+            int key = cv::waitKey(1);
+            if (key == 27) quit = true;
+            if (key == 'a') accuracyRequested = true;
+        }
+        cv::destroyAllWindows();
+    });
+
+    StageTimes times;
+    std::vector<cv::Rect> faces;    // 이전 프레임에서 찾은 얼굴
+    auto lastFrame = std::chrono::steady_clock::now();
+
+    while (!quit) {
+        cv::Mat frame;  // 매 프레임 새 버퍼 (얼굴/렌더 스레드가 참조)
         cap >> frame;
         if (frame.empty()) break;
 
-        cv::Mat img = frame.clone();
-        auto start = std::chrono::high_resolution_clock::now();
+        updateAverage(times.frame, elapsedMs(lastFrame));
+        lastFrame = std::chrono::steady_clock::now();
 
-        removeFaceArea(img, face_cascade);
-        cv::Mat mask = makeHandMask(img);
+        if (accuracyRequested.exchange(false)) {
+            // 원본 해상도 결과와 비교 (정확도 확인용)
+            cv::Mat masked = frame.clone();
+            for (const cv::Rect& face : faces) {
+                cv::rectangle(masked, face, cv::Scalar(0, 0, 0), cv::FILLED);
+            }
+            hand::PyramidAccuracy acc = pyramid.checkAccuracy(masked, segment);
+            std::cout << "Pyramid level " << pyramid.getLevel() << ": IoU " << acc.iou
+                      << ", area error " << acc.areaError << ", centroid offset " << acc.centroidOffset
+                      << ", defects " << acc.defects << " / " << acc.fullDefects << std::endl;
+        }
 
-        std::vector<std::vector<cv::Point>> contours;
-        cv::findContours(mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-        cv::drawContours(img, contours, -1, cv::Scalar(0, 255, 255), 2);
+        // 얼굴 검출(프레임 N)과 피부색 마스크(프레임 N, N-1의 얼굴 박스 사용)를 동시에
+        std::future<double> faceTask = std::async(std::launch::async, [&faceMasker, frame]() {
+            auto start = std::chrono::steady_clock::now();
+            faceMasker.update(frame);
+            return elapsedMs(start);
+        });
 
-        int maxIdx = findLargestContour(contours);
-        if (maxIdx != -1) {
-            cv::Rect handROI = cv::boundingRect(contours[maxIdx]);
-            rectangle(img, handROI, cv::Scalar(0, 255, 0), 2);
+        auto start = std::chrono::steady_clock::now();
+        cv::Mat mask = makeHandMask(pyramid.down(frame), pyramid.scaleKernel(SKIN_CLEAN_KSIZE));
+        maskFaces(mask, faces, pyramid.getScale());
+        updateAverage(times.skin, elapsedMs(start));
 
-            cv::Point center(handROI.x + handROI.width / 2, handROI.y + handROI.height / 2);
-            circle(img, center, 5, cv::Scalar(255, 255, 0), cv::FILLED);
+        // 가장 큰 blob만 윤곽선 추출 (이전 손 위치 주변 우선 탐색)
+        start = std::chrono::steady_clock::now();
+        RenderJob job;
+        const hand::Blob& blob = blobs.extract(mask);
+        if (blob.found) {
+            job.contours.assign(1, blob.contour);
+            pyramid.toFull(job.contours);
+            job.handROI = pyramid.toFull(blob.box);
 
+            cv::Point center(job.handROI.x + job.handROI.width / 2, job.handROI.y + job.handROI.height / 2);
             //detectSwipe(center, prevCenter, swipeThreshold, img);
             prevCenter = center;
         }
+        updateAverage(times.blob, elapsedMs(start));
 
-        auto end = std::chrono::high_resolution_clock::now();
-        double fps = 1000.0 / std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        updateAverage(times.face, faceTask.get());
+        times.render = renderMs;
 
-        drawFPS(fps, img);
-        cv::Mat combined = combineImages(img, mask);
-        cv::imshow("Hand Detection (Original + Mask)", combined);
+        job.frame = frame;
+        job.mask = mask;
+        job.faces = faces;
+        job.times = times;
+        {
+            std::lock_guard<std::mutex> lock(renderMutex);
+            renderJob = std::move(job);
+            hasRenderJob = true;
+        }
+        renderReady.notify_one();
 
-        if (cv::waitKey(1) == 27) break;
+        faces = faceMasker.getFaces();
     }
 
+    quit = true;
+    renderer.join();
+
+    std::cout << "Average per frame: face " << times.face << "ms (parallel), skin " << times.skin
+              << "ms, blob " << times.blob << "ms, render " << times.render << "ms (render thread), "
+              << "frame " << times.frame << "ms" << std::endl;
+
     cap.release();
-    cv::destroyAllWindows();
     return 0;
 }
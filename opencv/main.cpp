@@ -1,6 +1,12 @@
 #include <opencv2/opencv.hpp>
 #include <iostream>
 
+#include "GestureClassifier.hpp"
+#include "ProcessingPyramid.hpp"
+#include "SkinLut.hpp"
+
+#define PYRAMID_LEVEL (2)   // 마스크/윤곽선 처리 해상도 (0: 원본, 1: 1/2, 2: 1/4)
+
 int main() {
     cv::VideoCapture cam(0);
     if (!cam.isOpened()) {
@@ -15,51 +21,51 @@ int main() {
     // 고정된 HSV 범위 (밝은 환경 기준 손색)
     int minH = 0, minS = 20, minV = 100;
     int maxH = 30, maxS = 150, maxV = 255;
+    hand::SkinLut skinLut = hand::SkinLut::fromHsvRange(cv::Scalar(minH, minS, minV), cv::Scalar(maxH, maxS, maxV));
+
+    // 손가락 개수 세기에는 1/4 해상도 마스크로 충분, 윤곽선은 원본 좌표로 복원
+    hand::ProcessingPyramid pyramid(PYRAMID_LEVEL);
+    auto segment = [&skinLut](const cv::Mat& img, int scale, cv::Mat& mask) {
+        skinLut.apply(img, mask, hand::ProcessingPyramid::scaleKernel(5, scale));
+    };
 
-    cv::Mat frame, hsv, mask;
-    std::vector<std::vector<cv::Point>> contours;
-    std::vector<cv::Vec4i> hierarchy;
-    std::vector<cv::Point> hull;
-    std::vector<int> hullIdx;
-    std::vector<cv::Vec4i> defects;
+    // 결함은 깊이와 관계없이 모두 표시
+    hand::GestureOptions options;
+    options.minArea = 1000.0;
+    options.minDefectDepth = 0.f;
+    options.tracking = true;    // 이전 손 주변에서 먼저 탐색
+    hand::GestureClassifier classifier(options);
+
+    cv::Mat frame, mask;
+    bool checkAccuracy = false;
 
     while (true) {
         cam >> frame;
         if (frame.empty()) break;
 
-        // HSV 변환 + 마스크
-        cv::cvtColor(frame, hsv, cv::COLOR_BGR2HSV);
-        cv::inRange(hsv, cv::Scalar(minH, minS, minV), cv::Scalar(maxH, maxS, maxV), mask);
-        cv::medianBlur(mask, mask, 5);
-
-        // 가장 큰 윤곽선 탐색
-        cv::findContours(mask, contours, hierarchy, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-        int maxIdx = -1;
-        double maxArea = 1000.0;
-        for (size_t i = 0; i < contours.size(); i++) {
-            double area = cv::contourArea(contours[i]);
-            if (area > maxArea) {
-                maxArea = area;
-                maxIdx = static_cast<int>(i);
-            }
+        if (checkAccuracy) {
+            // 원본 해상도 결과와 비교 (정확도 확인용, 그리기 전 프레임 사용)
+            hand::PyramidAccuracy acc = pyramid.checkAccuracy(frame, segment);
+            std::cout << "Pyramid level " << pyramid.getLevel() << ": IoU " << acc.iou
+                      << ", area error " << acc.areaError << ", defects " << acc.defects
+                      << " / " << acc.fullDefects << std::endl;
         }
 
-        if (maxIdx != -1) {
-            cv::convexHull(contours[maxIdx], hull);
-            cv::convexHull(contours[maxIdx], hullIdx);
-            cv::convexityDefects(contours[maxIdx], hullIdx, defects);
+        // LUT 피부색 마스크 + 5x5 다수결 필터 (medianBlur 대체)
+        segment(pyramid.down(frame), pyramid.getScale(), mask);
 
+        // 가장 큰 윤곽선만 볼록 껍질/결함 계산
+        const hand::GestureResult& result = classifier.classify(mask, pyramid);
+        if (result.found) {
             // 손 중심점 + 박스
-            cv::Rect box = cv::boundingRect(hull);
-            cv::rectangle(frame, box, cv::Scalar(0, 0, 255), 1);
-            cv::Point center(box.x + box.width / 2, box.y + box.height / 2);
-            cv::circle(frame, center, 4, cv::Scalar(0, 255, 0), -1);
+            cv::rectangle(frame, result.box, cv::Scalar(0, 0, 255), 1);
+            cv::circle(frame, result.center, 4, cv::Scalar(0, 255, 0), -1);
 
             // defect 연결선 (간단 표시)
-            for (const auto& d : defects) {
-                cv::Point p1 = contours[maxIdx][d[0]];
-                cv::Point p2 = contours[maxIdx][d[1]];
-                cv::Point p3 = contours[maxIdx][d[2]];
+            for (const auto& d : result.defects) {
+                cv::Point p1 = result.contour[d[0]];
+                cv::Point p2 = result.contour[d[1]];
+                cv::Point p3 = result.contour[d[2]];
                 cv::line(frame, p1, p3, cv::Scalar(255, 255, 0), 1);
                 cv::line(frame, p3, p2, cv::Scalar(255, 255, 0), 1);
             }
@@ -67,7 +73,9 @@ int main() {
 
         // 디스플레이
         cv::imshow("Hand Detection", frame);
-        if (cv::waitKey(10) == 27) break;  // ESC 키 종료
+        int key = cv::waitKey(10);
+        if (key == 27) break;  // ESC 키 종료
+        checkAccuracy = (key == 'a');
     }
 
     return 0;
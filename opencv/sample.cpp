@@ -2,6 +2,11 @@
 #include <opencv2/highgui/highgui.hpp>
 #include <iostream>
 
+#include "GestureClassifier.hpp"
+#include "ProcessingPyramid.hpp"
+
+#define PYRAMID_LEVEL (1)   // 블러/이진화/윤곽선 처리 해상도 (0: 원본, 1: 1/2, 2: 1/4)
+
 using namespace cv;
 using namespace std;
 
@@ -22,6 +27,13 @@ int main( int argc, const char** argv)
     namedWindow("ROI",cv::WINDOW_AUTOSIZE);
     char a[40];
     int count =0;
+    hand::ProcessingPyramid pyramid(PYRAMID_LEVEL);
+
+    // 5000px 이상 blob, 13px 이상 깊이의 결함을 손가락 사이로 판단
+    hand::GestureOptions options;
+    options.minArea = 5000;
+    options.minDefectDepth = 13;
+    hand::GestureClassifier classifier(options);
     while(1){
         bool b=cam.read(img);
         if(!b){
@@ -32,92 +44,53 @@ int main( int argc, const char** argv)
         img_roi=img(roi);
         cvtColor(img_roi,img_gray,cv::COLOR_RGB2GRAY);
 
-        GaussianBlur(img_gray,img_gray,Size(19,19),0.0,0);
-        threshold(img_gray,img_threshold,0,255,THRESH_BINARY_INV+THRESH_OTSU);
+        // 축소 해상도에서 블러 + OTSU + 윤곽선, 윤곽선은 ROI 원본 좌표로 복원
+        Mat img_small;
+        int ksize = pyramid.scaleKernel(19);
+        GaussianBlur(pyramid.down(img_gray),img_small,Size(ksize,ksize),0.0,0);
+        threshold(img_small,img_threshold,0,255,THRESH_BINARY_INV+THRESH_OTSU);
 
-        vector<vector<Point> >contours;
-        vector<Vec4i>hierarchy;
-        findContours(img_threshold,contours,hierarchy,cv::RETR_EXTERNAL,cv::CHAIN_APPROX_SIMPLE,Point());
-        if(contours.size()>0){
-                size_t indexOfBiggestContour = -1;
-	            size_t sizeOfBiggestContour = 0;
-
-	            for (size_t i = 0; i < contours.size(); i++){
-		           if(contours[i].size() > sizeOfBiggestContour){
-			       sizeOfBiggestContour = contours[i].size();
-			       indexOfBiggestContour = i;
-		          }
+        // 가장 큰 blob만 볼록 껍질/결함 계산 (버퍼 재사용)
+        const hand::GestureResult& result = classifier.classify(img_threshold,pyramid);
+        resize(img_threshold,img_threshold,img_roi.size(),0,0,INTER_NEAREST);
+        if(result.found){
+                for(const Point& tip : result.tips){
+                    circle(img_roi,tip,3,Scalar(0,255,0),2);
                 }
-                vector<vector<int> >hull(contours.size());
-                vector<vector<Point> >hullPoint(contours.size());
-                vector<vector<Vec4i> >defects(contours.size());
-                vector<vector<Point> >defectPoint(contours.size());
-                vector<vector<Point> >contours_poly(contours.size());
-                Point2f rect_point[4];
-                vector<RotatedRect>minRect(contours.size());
-                vector<Rect> boundRect(contours.size());
-                for(size_t i=0;i<contours.size();i++){
-                    if(contourArea(contours[i])>5000){
-                        convexHull(contours[i],hull[i],true);
-                        convexityDefects(contours[i],hull[i],defects[i]);
-                        if(indexOfBiggestContour==i){
-                            minRect[i]=minAreaRect(contours[i]);
-                            for(size_t k=0;k<hull[i].size();k++){
-                                int ind=hull[i][k];
-                                hullPoint[i].push_back(contours[i][ind]);
-                            }
-                            count =0;
+                count = result.gaps;
 
-                            for(size_t k=0;k<defects[i].size();k++){
-                                if(defects[i][k][3]>13*256){
-                                 /*   int p_start=defects[i][k][0];   */
-                                    int p_end=defects[i][k][1];
-                                    int p_far=defects[i][k][2];
-                                    defectPoint[i].push_back(contours[i][p_far]);
-                                    circle(img_roi,contours[i][p_end],3,Scalar(0,255,0),2);
-                                    count++;
-                                }
+                if(count==1)
+                    strcpy(a,"Hello :D ");
+                else if(count==2)
+                    strcpy(a,"Peace :) ");
+                else if(count==3)
+                    strcpy(a,"3 it is !!");
+                else if(count==4)
+                    strcpy(a,"0100");
+                else if(count==5)
+                    strcpy(a,"FIVE");
+                else
+                    strcpy(a,"Welcome !!");
 
-                            }
-
-                            if(count==1)
-                                strcpy(a,"Hello :D ");
-                            else if(count==2)
-                                strcpy(a,"Peace :) ");
-                            else if(count==3)
-                                strcpy(a,"3 it is !!");
-                            else if(count==4)
-                                strcpy(a,"0100");
-                            else if(count==5)
-                                strcpy(a,"FIVE");
-                            else
-                                strcpy(a,"Welcome !!");
-
-                            putText(img,a,Point(70,70),cv::FONT_HERSHEY_SIMPLEX,3,Scalar(255,0,0),2,8,false);
-                            drawContours(img_threshold, contours, i,Scalar(255,255,0),2, 8, vector<Vec4i>(), 0, Point() );
-                            drawContours(img_threshold, hullPoint, i, Scalar(255,255,0),1, 8, vector<Vec4i>(),0, Point());
-                            drawContours(img_roi, hullPoint, i, Scalar(0,0,255),2, 8, vector<Vec4i>(),0, Point() );
-                            approxPolyDP(contours[i],contours_poly[i],3,false);
-                            boundRect[i]=boundingRect(contours_poly[i]);
-                            rectangle(img_roi,boundRect[i].tl(),boundRect[i].br(),Scalar(255,0,0),2,8,0);
-                            minRect[i].points(rect_point);
-                            for(size_t k=0;k<4;k++){
-                                line(img_roi,rect_point[k],rect_point[(k+1)%4],Scalar(0,255,0),2,8);
-                            }
-
-                        }
-                    }
+                putText(img,a,Point(70,70),cv::FONT_HERSHEY_SIMPLEX,3,Scalar(255,0,0),2,8,false);
+                polylines(img_threshold,result.contour,true,Scalar(255,255,0),2,8);
+                polylines(img_threshold,result.hull,true,Scalar(255,255,0),1,8);
+                polylines(img_roi,result.hull,true,Scalar(0,0,255),2,8);
+                rectangle(img_roi,result.box.tl(),result.box.br(),Scalar(255,0,0),2,8,0);
 
+                Point2f rect_point[4];
+                minAreaRect(result.contour).points(rect_point);
+                for(size_t k=0;k<4;k++){
+                    line(img_roi,rect_point[k],rect_point[(k+1)%4],Scalar(0,255,0),2,8);
                 }
-            imshow("Original_image",img);
-            imshow("Gray_image",img_gray);
-            imshow("Thresholded_image",img_threshold);
-            imshow("ROI",img_roi);
-            if(waitKey(30)==27){
-                  return -1;
-             }
-
         }
+        imshow("Original_image",img);
+        imshow("Gray_image",img_gray);
+        imshow("Thresholded_image",img_threshold);
+        imshow("ROI",img_roi);
+        if(waitKey(30)==27){
+              return -1;
+         }
 
     }
 
@@ -0,0 +1,190 @@
+#include "SwipeDetector.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+
+hand::SwipeDetector::SwipeDetector(const SwipeOptions& options) : m_options(options) {
+    reset();
+}
+
+
+int hand::SwipeDetector::update(const cv::Mat& frame) {
+    if (frame.channels() == 3)
+        cv::cvtColor(frame, m_gray, cv::COLOR_BGR2GRAY);
+    else
+        frame.copyTo(m_gray);
+    cv::GaussianBlur(m_gray, m_gray, cv::Size(5, 5), 0);
+
+    subtractBackground();
+    if (m_options.morphIterations > 0) {
+        cv::erode(m_mask, m_mask, cv::Mat(), cv::Point(-1, -1), m_options.morphIterations);
+        cv::dilate(m_mask, m_mask, cv::Mat(), cv::Point(-1, -1), m_options.morphIterations);
+    }
+
+    m_area = projectColumns();
+
+    m_minX = -1;
+    m_maxX = -1;
+    if (m_area == 0) {
+        m_motionScore = 0;
+        return SWIPE_NONE;
+    }
+
+    auto first = std::find_if(m_columns.begin(), m_columns.end(), [](uint16_t c) { return c != 0; });
+    auto last = std::find_if(m_columns.rbegin(), m_columns.rend(), [](uint16_t c) { return c != 0; });
+    m_minX = (int)(first - m_columns.begin());
+    m_maxX = (int)(m_columns.rend() - last) - 1;
+
+    int events = updatePalm();
+    events |= updateSwipe();
+    return events;
+}
+
+
+int hand::SwipeDetector::getMotionArea() const {
+    return m_area;
+}
+
+
+int hand::SwipeDetector::getMinX() const {
+    return m_minX;
+}
+
+
+int hand::SwipeDetector::getMaxX() const {
+    return m_maxX;
+}
+
+
+bool hand::SwipeDetector::isPalmDetected() const {
+    return m_palmDetected;
+}
+
+
+const cv::Mat& hand::SwipeDetector::getMotionMask() const {
+    return m_mask;
+}
+
+
+void hand::SwipeDetector::reset() {
+    m_hasBackground = false;
+    m_area = 0;
+    m_lastArea = 0;
+    m_minX = -1;
+    m_maxX = -1;
+    m_prevMinX = -1;
+    m_prevMaxX = -1;
+    m_motionScore = 0;
+    m_palmDetected = false;
+}
+
+//-------------------Private methods start here-------------------
+
+void hand::SwipeDetector::subtractBackground() {
+    if (m_hasBackground == false || m_background.size() != m_gray.size()) {
+        m_gray.convertTo(m_background, CV_16U, 256.0);
+        m_hasBackground = true;
+    }
+    m_mask.create(m_gray.size(), CV_8U);
+
+    const int rate = m_options.learningRate;
+    const int threshold = m_options.diffThreshold;
+    const int cols = m_gray.cols;
+
+    for (int y = 0; y < m_gray.rows; ++y) {
+        const uint8_t* gray = m_gray.ptr<uint8_t>(y);
+        uint16_t* bg = m_background.ptr<uint16_t>(y);
+        uint8_t* mask = m_mask.ptr<uint8_t>(y);
+
+        /*
+        bg += (gray - bg) * rate, then compare gray with the rounded background
+        (same order as accumulateWeighted + convertTo + absdiff + threshold).
+        Plain integer arithmetic, vectorized by the compiler at -O3 (see Makefile)
+        as long as the trip count is a local: m_gray.cols would be reloaded
+        after every store.
+        */
+        for (int x = 0; x < cols; ++x) {
+            int g = gray[x];
+            int b = bg[x];
+            b += (((g << 8) - b) * rate + 128) >> 8;
+            bg[x] = (uint16_t)b;
+
+            int diff = std::abs(g - ((b + 128) >> 8));
+            mask[x] = diff > threshold ? 255 : 0;
+        }
+    }
+}
+
+
+int hand::SwipeDetector::projectColumns() {
+    const int cols = m_mask.cols;
+    m_columns.assign(cols, 0);
+    uint16_t* columns = m_columns.data();
+
+    /*
+    The mask is 0 or 255, & 1 counts a moving pixel.
+    uint16 columns hold up to 65535 rows.
+    */
+    for (int y = 0; y < m_mask.rows; ++y) {
+        const uint8_t* mask = m_mask.ptr<uint8_t>(y);
+        for (int x = 0; x < cols; ++x) {
+            columns[x] += mask[x] & 1;
+        }
+    }
+
+    int area = 0;
+    for (int x = 0; x < cols; ++x) {
+        area += columns[x];
+    }
+    return area;
+}
+
+
+int hand::SwipeDetector::updateSwipe() {
+    int events = SWIPE_NONE;
+
+    if (m_prevMinX != -1 && m_prevMaxX != -1) {
+        int dxMax = m_maxX - m_prevMaxX;
+        int dxMin = m_minX - m_prevMinX;
+
+        if (dxMax > m_options.motionThreshold)
+            m_motionScore = (m_motionScore >= 0) ? m_motionScore + 1 : 0;
+        else if (dxMin < -m_options.motionThreshold)
+            m_motionScore = (m_motionScore <= 0) ? m_motionScore - 1 : 0;
+        else
+            m_motionScore = 0;
+
+        /*
+        The camera image is mirrored: moving right in the image is a left swipe.
+        */
+        if (m_motionScore >= m_options.triggerScore) {
+            events = SWIPE_LEFT;
+            m_motionScore = 0;
+        }
+        else if (m_motionScore <= -m_options.triggerScore) {
+            events = SWIPE_RIGHT;
+            m_motionScore = 0;
+        }
+    }
+
+    m_prevMinX = m_minX;
+    m_prevMaxX = m_maxX;
+    return events;
+}
+
+
+int hand::SwipeDetector::updatePalm() {
+    int events = SWIPE_NONE;
+
+    if (!m_palmDetected && m_lastArea < m_options.palmStartArea && m_area > m_options.palmStopArea) {
+        events = PALM_STOP;
+        m_palmDetected = true;
+    }
+
+    if (m_palmDetected && m_area < m_options.palmReleaseArea)
+        m_palmDetected = false;
+
+    m_lastArea = m_area;
+    return events;
+}
@@ -0,0 +1,118 @@
+#ifndef SWIPEDETECTOR_H
+#define SWIPEDETECTOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace hand {
+
+    /*
+    Events reported by SwipeDetector::update(), can be combined.
+    */
+    enum SwipeEvent {
+        SWIPE_NONE  = 0,
+        SWIPE_LEFT  = 1 << 0,
+        SWIPE_RIGHT = 1 << 1,
+        PALM_STOP   = 1 << 2
+    };
+
+    /*
+    Attributes:
+        learningRate: background update weight, in 1/256 (13 ~ 0.05)
+        diffThreshold: gray level difference to the background counted as motion
+        morphIterations: erode then dilate iterations on the motion mask
+        motionThreshold: extent move (pixels) counted as a swipe step
+        triggerScore: consecutive swipe steps needed for an event
+        palmStopArea: motion area (pixels) of a palm pushed toward the camera
+        palmStartArea: the area must come from below this
+        palmReleaseArea: the palm is released below this area
+    */
+    struct SwipeOptions {
+        int learningRate = 13;
+        int diffThreshold = 40;
+        int morphIterations = 2;
+        int motionThreshold = 10;
+        int triggerScore = 5;
+        int palmStopArea = 12000;
+        int palmStartArea = 5000;
+        int palmReleaseArea = 3000;
+    };
+
+    /*
+    Swipe and palm-stop detection from background subtraction.
+    The running average background is kept in 8.8 fixed point (uint16)
+    and updated in the same pass that thresholds the difference. The motion
+    extent (leftmost / rightmost moving column) and area come from a
+    column occupancy projection of the motion mask, one vectorizable pass
+    without any point list.
+    */
+    class SwipeDetector {
+        public:
+            SwipeDetector(const SwipeOptions& options = SwipeOptions());
+
+            /*
+            Process a frame (BGR or gray). Return a combination of SwipeEvent.
+            */
+            int update(const cv::Mat& frame);
+
+            /*
+            Moving pixels of the last frame
+            */
+            int getMotionArea() const;
+
+            /*
+            Leftmost and rightmost moving columns of the last frame, -1 if no motion
+            */
+            int getMinX() const;
+            int getMaxX() const;
+
+            bool isPalmDetected() const;
+
+            /*
+            Motion mask of the last frame (CV_8U, 0 or 255)
+            */
+            const cv::Mat& getMotionMask() const;
+
+            /*
+            Forget the background and the swipe state.
+            */
+            void reset();
+
+        private:
+            /*
+            Update the background with m_gray and threshold the difference into m_mask.
+            */
+            void subtractBackground();
+
+            /*
+            Column occupancy of m_mask into m_columns, return the moving pixel count.
+            */
+            int projectColumns();
+
+            int updateSwipe();
+            int updatePalm();
+
+        private:
+            SwipeOptions m_options;
+
+            cv::Mat m_gray;
+            cv::Mat m_background;   // CV_16U, gray level << 8
+            bool m_hasBackground;
+            cv::Mat m_mask;
+            std::vector<uint16_t> m_columns;
+
+            int m_area;
+            int m_lastArea;
+            int m_minX;
+            int m_maxX;
+            int m_prevMinX;
+            int m_prevMaxX;
+            int m_motionScore;
+            bool m_palmDetected;
+    };
+}
+
+#endif // SWIPEDETECTOR_H
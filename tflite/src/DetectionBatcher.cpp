@@ -0,0 +1,155 @@
+#include "DetectionBatcher.hpp"
+#include "HandDetection.hpp"
+
+#include <algorithm>
+
+
+/*
+Helper function
+*/
+static int __roundUpPowerOfTwo(int n) {
+    int power = 1;
+    while (power < n) {
+        power *= 2;
+    }
+    return power;
+}
+
+
+hand::DetectionBatcher::DetectionBatcher(SharedModel palmModel, int maxBatch,
+                                         double windowMs, int numThreads) :
+    m_model(std::move(palmModel), numThreads),
+    m_maxBatch(std::max(1, maxBatch)),
+    m_window(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(windowMs))),
+    m_canBatch(true), m_stop(false), m_waitSumMs(0.0), m_invokeSumMs(0.0)
+{
+    m_thread = std::thread(&DetectionBatcher::run, this);
+}
+
+
+hand::DetectionBatcher::~DetectionBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_ready.notify_one();
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+
+cv::Rect hand::DetectionBatcher::detect(const cv::Mat& image) {
+    return submit(image).get();
+}
+
+
+std::future<cv::Rect> hand::DetectionBatcher::submit(const cv::Mat& image) {
+    Request request;
+    request.image = image;
+    request.arrival = std::chrono::steady_clock::now();
+    std::future<cv::Rect> result = request.result.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(request));
+    }
+    m_ready.notify_one();
+    return result;
+}
+
+
+hand::DetectionBatchStats hand::DetectionBatcher::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+//-------------------Private methods start here-------------------
+
+void hand::DetectionBatcher::run() {
+    std::vector<Request> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_ready.wait(lock, [this] { return m_stop || m_queue.empty() == false; });
+            if (m_queue.empty())
+                break;
+
+            /*
+            Wait for more requests until the batch is full or the oldest one is due
+            */
+            auto due = m_queue.front().arrival + m_window;
+            m_ready.wait_until(lock, due, [this] { return m_stop || (int)m_queue.size() >= m_maxBatch; });
+
+            int n = std::min((int)m_queue.size(), m_maxBatch);
+            for (int i = 0; i < n; ++i) {
+                batch.push_back(std::move(m_queue.front()));
+                m_queue.pop_front();
+            }
+        }
+
+        runBatch(batch);
+        batch.clear();
+    }
+}
+
+
+void hand::DetectionBatcher::runBatch(std::vector<Request>& batch) {
+    auto start = std::chrono::steady_clock::now();
+    const int n = batch.size();
+
+    int batchSize = m_canBatch ? __roundUpPowerOfTwo(n) : 1;
+    if (m_model.getBatchSize() != batchSize && m_model.setBatchSize(batchSize) == false) {
+        m_canBatch = false;
+        batchSize = 1;
+        m_model.setBatchSize(1);
+    }
+
+    std::vector<cv::Rect> rois(n);
+    if (batchSize >= n) {
+        for (int slot = 0; slot < batchSize; ++slot) {
+            m_model.loadImageToBatch(batch[std::min(slot, n - 1)].image, slot);
+        }
+        m_model.runInference();
+        for (int i = 0; i < n; ++i) {
+            rois[i] = decodeSlot(i, batch[i].image.size());
+        }
+    }
+    else {
+        for (int i = 0; i < n; ++i) {
+            m_model.loadImageToInput(batch[i].image);
+            m_model.runInference();
+            rois[i] = decodeSlot(0, batch[i].image.size());
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.requests += n;
+        m_stats.batches++;
+        m_stats.padded += std::max(0, batchSize - n);
+        m_stats.avgBatchSize = (double)m_stats.requests / m_stats.batches;
+
+        m_invokeSumMs += std::chrono::duration<double, std::milli>(end - start).count();
+        m_stats.avgInvokeMs = m_invokeSumMs / m_stats.batches;
+        for (const auto& request : batch) {
+            m_waitSumMs += std::chrono::duration<double, std::milli>(end - request.arrival).count();
+        }
+        m_stats.avgWaitMs = m_waitSumMs / m_stats.requests;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        batch[i].result.set_value(rois[i]);
+    }
+}
+
+
+cv::Rect hand::DetectionBatcher::decodeSlot(int slot, const cv::Size& size) const {
+    auto detections = HandDetection::readDetections(m_model, m_postProcessor, slot);
+    if (detections.empty())
+        return cv::Rect();
+
+    auto best = std::max_element(detections.begin(), detections.end(),
+        [](const Detection& a, const Detection& b) { return a.score < b.score; });
+    return HandDetection::calculateRoi(*best, size);
+}
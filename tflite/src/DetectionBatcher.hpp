@@ -0,0 +1,114 @@
+#ifndef DETECTIONBATCHER_H
+#define DETECTIONBATCHER_H
+
+#include "ModelLoader.hpp"
+#include "DetectionPostProcess.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define BATCH_DEFAULT_WINDOW_MS 4.0     // Max wait of the first request of a batch
+
+namespace hand {
+
+    /*
+    Attributes:
+        requests: images detected
+        batches: invokes run
+        padded: unused slots run to keep the batch size stable
+        avgBatchSize: requests per invoke
+        avgWaitMs: mean time from detect() to its result
+        avgInvokeMs: mean duration of one batch (load, invoke, decode)
+    */
+    struct DetectionBatchStats {
+        size_t requests = 0;
+        size_t batches = 0;
+        size_t padded = 0;
+        double avgBatchSize = 0.0;
+        double avgWaitMs = 0.0;
+        double avgInvokeMs = 0.0;
+    };
+
+    /*
+    Palm detection for several streams in one invoke.
+    detect() may be called from many threads (e.g. the InferencePool sessions).
+    Requests are collected until maxBatch of them wait, or the oldest one
+    waited windowMs, then the palm model runs once with its batch dimension
+    resized, and each caller gets the roi of its own image back.
+    A request waits at most windowMs plus one batch.
+
+    The batch size is rounded up to a power of two (the spare slots repeat
+    the last image) so the tensors are only reallocated for a few sizes.
+    Models which cannot run batched fall back to one invoke per request.
+    This class is non-copyable.
+    */
+    class DetectionBatcher {
+        public:
+            /*
+            Parameters:
+                palmModel: palm detection model (see HandModels)
+                maxBatch: flush as soon as this many requests wait
+                windowMs: flush when the oldest request waited this long
+                numThreads: threads of the tflite interpreter (-1: let tflite decide)
+            */
+            DetectionBatcher(SharedModel palmModel, int maxBatch,
+                             double windowMs = BATCH_DEFAULT_WINDOW_MS, int numThreads = -1);
+            DetectionBatcher(const DetectionBatcher& other) = delete;
+            DetectionBatcher& operator=(const DetectionBatcher& other) = delete;
+            ~DetectionBatcher();
+
+            /*
+            Queue image (BGR) and wait for its batch. Return the hand roi of the
+            highest score detection, in image pixels (empty if there is none),
+            same as HandDetection::getHandRoi().
+            */
+            cv::Rect detect(const cv::Mat& image);
+
+            /*
+            Queue image without waiting.
+            */
+            std::future<cv::Rect> submit(const cv::Mat& image);
+
+            DetectionBatchStats getStats() const;
+
+        private:
+            struct Request {
+                cv::Mat image;
+                std::chrono::steady_clock::time_point arrival;
+                std::promise<cv::Rect> result;
+            };
+
+            void run();
+            void runBatch(std::vector<Request>& batch);
+
+            /*
+            Highest score hand of slot of the batch, in pixels of an image of size
+            */
+            cv::Rect decodeSlot(int slot, const cv::Size& size) const;
+
+        private:
+            ModelLoader m_model;
+            DetectionPostProcess m_postProcessor;
+            int m_maxBatch;
+            std::chrono::steady_clock::duration m_window;
+            bool m_canBatch;
+
+            std::thread m_thread;
+            mutable std::mutex m_mutex;
+            std::condition_variable m_ready;
+            std::deque<Request> m_queue;
+            bool m_stop;
+
+            DetectionBatchStats m_stats;
+            double m_waitSumMs;
+            double m_invokeSumMs;
+    };
+}
+
+#endif // DETECTIONBATCHER_H
@@ -1,4 +1,5 @@
 #include "DetectionPostProcess.hpp"
+#include "PalmDecodeOp.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -42,7 +43,7 @@ hand::DetectionPostProcess::DetectionPostProcess() :
 
 
 cv::Rect2f hand::DetectionPostProcess::decodeBox
-(const std::vector<float>& rawBoxes, int index) const {
+(const float* rawBoxes, int index) const {
     auto anchor = m_anchors[index];
     auto center = (anchor.tl() + anchor.br()) * 0.5;
     
@@ -66,9 +67,67 @@ hand::Detection hand::DetectionPostProcess::getHighestScoreDetection
     hand::Detection detection;
     for (int i = 0; i < NUM_BOXES; i++) {
         if (scores[i] > std::max(MIN_THRESHOLD, detection.score)) {
-            auto data = decodeBox(rawBoxes, i);
+            auto data = decodeBox(rawBoxes.data(), i);
             detection = hand::Detection(scores[i], CLASS_ID, data);
         }
     }
     return detection;
 }
+
+
+std::vector<hand::Detection> hand::DetectionPostProcess::getDetections
+(const float* rawBoxes, const float* scores, float threshold) const {
+    std::vector<Detection> detections;
+    for (int i = 0; i < NUM_BOXES; i++) {
+        if (scores[i] > threshold)
+            detections.emplace_back(scores[i], CLASS_ID, decodeBox(rawBoxes, i), i);
+    }
+    return detections;
+}
+
+
+std::vector<cv::Point2f> hand::DetectionPostProcess::decodeKeypoints
+(const float* rawBoxes, int index) const {
+    auto anchor = m_anchors[index];
+    auto center = (anchor.tl() + anchor.br()) * 0.5;
+
+    std::vector<cv::Point2f> keypoints(NUM_KEYPOINTS);
+    const float* raw = rawBoxes + index * NUM_COORD + 4;
+    for (int k = 0; k < NUM_KEYPOINTS; ++k) {
+        keypoints[k].x = raw[2 * k] / DETECTION_SIZE * anchor.width + center.x;
+        keypoints[k].y = raw[2 * k + 1] / DETECTION_SIZE * anchor.height + center.y;
+    }
+    return keypoints;
+}
+
+
+std::vector<hand::Detection> hand::DetectionPostProcess::readDecodedDetections(const float* decoded, int count) {
+    std::vector<Detection> detections;
+    for (int i = 0; i < count; ++i) {
+        const float* row = decoded + i * PALM_DECODE_NUM_VALUES;
+        detections.emplace_back(row[0], CLASS_ID, cv::Rect2f(row[1], row[2], row[3], row[4]));
+    }
+    return detections;
+}
+
+
+std::vector<hand::Detection> hand::nonMaxSuppression(std::vector<Detection> detections, float iouThreshold) {
+    std::sort(detections.begin(), detections.end(), 
+        [](const Detection& a, const Detection& b) { return a.score > b.score; });
+
+    std::vector<Detection> kept;
+    for (const auto& detection : detections) {
+        bool overlaps = false;
+        for (const auto& other : kept) {
+            float inter = (detection.roi & other.roi).area();
+            float iou = inter / (detection.roi.area() + other.roi.area() - inter);
+            if (iou > iouThreshold) {
+                overlaps = true;
+                break;
+            }
+        }
+        if (overlaps == false)
+            kept.push_back(detection);
+    }
+    return kept;
+}
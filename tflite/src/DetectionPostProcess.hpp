@@ -12,6 +12,7 @@
 #define DETECTION_SIZE  192
 #define NUM_BOXES       2944
 #define NUM_COORD       18
+#define NUM_KEYPOINTS   7       // Palm keypoints (x, y) after the 4 box values
 #define NUM_SIZES       2
 
 namespace hand {
@@ -31,10 +32,11 @@ namespace hand {
         cv::Rect2f roi;
         float score;
         int classId;
+        int anchor;     // Index of the raw box it was decoded from (-1: unknown)
 
-        Detection() : score(), classId(-1), roi() {}
-        Detection(float score, int classId, cv::Rect2f roi) :
-            score(score), classId(classId), roi(roi) {}
+        Detection() : score(), classId(-1), roi(), anchor(-1) {}
+        Detection(float score, int classId, cv::Rect2f roi, int anchor = -1) :
+            score(score), classId(classId), roi(roi), anchor(anchor) {}
         ~Detection() = default;
     };
 
@@ -48,12 +50,36 @@ namespace hand {
             Detection getHighestScoreDetection
             (const std::vector<float>& rawBoxes, const std::vector<float>& scores) const;
 
+            /*
+            Every detection above threshold, boxes relative to the model input [0..1].
+            rawBoxes and scores point to the outputs of one image (NUM_BOXES boxes).
+            */
+            std::vector<Detection> getDetections(const float* rawBoxes, const float* scores,
+                                                 float threshold = MIN_THRESHOLD) const;
+
+            /*
+            The NUM_KEYPOINTS keypoints of raw box index, relative to the model input [0..1].
+            */
+            std::vector<cv::Point2f> decodeKeypoints(const float* rawBoxes, int index) const;
+
+            /*
+            Read the output of the in-graph decode op (see PalmDecodeOp.hpp) for one image:
+            count rows of PALM_DECODE_NUM_VALUES, best first.
+            */
+            static std::vector<Detection> readDecodedDetections(const float* decoded, int count);
+
         private:
-            cv::Rect2f decodeBox(const std::vector<float>& rawBoxes, int index) const;
+            cv::Rect2f decodeBox(const float* rawBoxes, int index) const;
 
         private:
             std::vector<cv::Rect2f> m_anchors;
     };
+
+    /*
+    Greedy non-maximum suppression: keep the highest scores, drop the
+    detections overlapping a kept one by more than iouThreshold.
+    */
+    std::vector<Detection> nonMaxSuppression(std::vector<Detection> detections, float iouThreshold);
 }
 
 #endif // DETECTIONPOSTPROCESS_H
\ No newline at end of file
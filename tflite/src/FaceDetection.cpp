@@ -0,0 +1,115 @@
+#include "FaceDetection.hpp"
+
+#include <cmath>
+#include <iostream>
+
+#define FACE_BOX_COORDS 16   // 4 box + 6 keypoints * 2 per anchor
+
+
+hand::FaceDetection::FaceDetection(std::string modelDir, int numThreads) :
+    hand::ModelLoader(modelDir + std::string(FACE_DETECTION_MODEL), numThreads),
+    m_boxesIndex(0), m_scoresIndex(1)
+{
+    /*
+    Regressors are [1, 896, 16] and classificators [1, 896, 1],
+    tell them apart by shape rather than by order.
+    */
+    if (getNumberOfOutputs() >= 2 && getOutputShape(0).back() == 1) {
+        m_boxesIndex = 1;
+        m_scoresIndex = 0;
+    }
+    m_inputSize = getInputShape()[1];
+
+    generateAnchors();
+    if (getOutputSize(m_scoresIndex) / sizeof(float) != m_anchors.size()) {
+        std::cerr << "Face model has " << getOutputSize(m_scoresIndex) / sizeof(float)
+                  << " boxes, expected " << m_anchors.size() << "." << std::endl;
+        std::exit(1);
+    }
+}
+
+
+void hand::FaceDetection::loadImageToInput(const cv::Mat& in, int index) {
+    m_imageSize = in.size();
+    ModelLoader::loadImageToInput(in);
+}
+
+
+void hand::FaceDetection::runInference() {
+    ModelLoader::runInference();
+
+    const float* rawBoxes = getOutputData(m_boxesIndex);
+    const float* rawScores = getOutputData(m_scoresIndex);
+
+    /*
+    Scores are logits: compare against the logit of FACE_MIN_SCORE
+    so that only the survivors need a sigmoid.
+    */
+    const float minLogit = std::log(FACE_MIN_SCORE / (1.f - FACE_MIN_SCORE));
+
+    std::vector<Detection> candidates;
+    for (int i = 0; i < (int)m_anchors.size(); ++i) {
+        if (rawScores[i] < minLogit)
+            continue;
+
+        float score = 1.f / (1.f + std::exp(-std::max(-100.f, std::min(100.f, rawScores[i]))));
+        candidates.emplace_back(score, 0, decodeBox(rawBoxes, i));
+    }
+    m_detections = nonMaxSuppression(candidates, FACE_NMS_THRESHOLD);
+}
+
+
+std::vector<cv::Rect> hand::FaceDetection::getFaces(float boxScale) const {
+    std::vector<cv::Rect> faces;
+    for (const auto& detection : m_detections) {
+        float cx = (detection.roi.x + detection.roi.width / 2) * m_imageSize.width;
+        float cy = (detection.roi.y + detection.roi.height / 2) * m_imageSize.height;
+        float w = detection.roi.width * m_imageSize.width * boxScale;
+        float h = detection.roi.height * m_imageSize.height * boxScale;
+
+        faces.emplace_back(cvRound(cx - w / 2), cvRound(cy - h / 2), cvRound(w), cvRound(h));
+    }
+    return faces;
+}
+
+
+std::vector<cv::Rect> hand::FaceDetection::detect(const cv::Mat& image, float boxScale) {
+    loadImageToInput(image);
+    runInference();
+    return getFaces(boxScale);
+}
+
+//-------------------Private methods start here-------------------
+
+void hand::FaceDetection::generateAnchors() {
+    AnchorOptions options;
+    m_anchors.clear();
+    m_anchors.reserve(FACE_NUM_ANCHORS);
+
+    for (int i = 0; i < NUM_SIZES; ++i) {
+        int size = options.sizes[i];
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                for (int n = 0; n < options.numLayers[i]; ++n) {
+                    m_anchors.emplace_back((x + options.offsetX) / size, (y + options.offsetY) / size);
+                }
+            }
+        }
+    }
+}
+
+
+cv::Rect2f hand::FaceDetection::decodeBox(const float* rawBoxes, int index) const {
+    const auto& anchor = m_anchors[index];
+    const float* raw = rawBoxes + index * FACE_BOX_COORDS;
+
+    /*
+    Anchors have a fixed size of 1, offsets are in input pixels.
+    */
+    float cx = raw[0] / m_inputSize + anchor.x;
+    float cy = raw[1] / m_inputSize + anchor.y;
+    float w = raw[2] / m_inputSize;
+    float h = raw[3] / m_inputSize;
+
+    return cv::Rect2f(cx - w / 2, cy - h / 2, w, h);
+}
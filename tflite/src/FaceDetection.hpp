@@ -0,0 +1,71 @@
+#ifndef FACEDETECTION_H
+#define FACEDETECTION_H
+
+#include "ModelLoader.hpp"
+#include "DetectionPostProcess.hpp"
+
+#define FACE_DETECTION_MODEL    "/face_detection_short.tflite"
+#define FACE_NUM_ANCHORS        896
+#define FACE_MIN_SCORE          0.5f
+#define FACE_NMS_THRESHOLD      0.3f
+
+namespace hand {
+
+    /*
+    A model wrapper to use Mediapipe (BlazeFace) Face Detector, short range.
+    Unlike HandDetection, it keeps every face above FACE_MIN_SCORE (after NMS),
+    which is what face exclusion needs.
+    This class is non-copyable.
+    */
+    class FaceDetection : public hand::ModelLoader {
+        public:
+            /*
+            Users MUST provide the FOLDER contain face_detection_short.tflite, NOT THE FILE itself.
+            */
+            FaceDetection(std::string modelDir, int numThreads = -1);
+            virtual ~FaceDetection() = default;
+
+            /*
+            Override function from ModelLoader.
+            (Note: index does not matter, the model always load to InputTensor(0))
+            */
+            virtual void loadImageToInput(const cv::Mat& inputImage, int index = 0);
+
+            /*
+            Override function from ModelLoader.
+            Can only run when all input tensors have been loaded.
+            */
+            virtual void runInference();
+
+            /*
+            Get the faces found by the last inference, relative to the image passed to loadImageToInput().
+            Each box is scaled by boxScale around its center (the model box is tight around the face).
+            */
+            std::vector<cv::Rect> getFaces(float boxScale = 1.f) const;
+
+            /*
+            loadImageToInput(), runInference() then getFaces().
+            */
+            std::vector<cv::Rect> detect(const cv::Mat& image, float boxScale = 1.f);
+
+        private:
+            using ModelLoader::loadBytesToInput;
+
+            /*
+            SSD anchors of BlazeFace (see AnchorOptions), fixed size 1x1
+            */
+            void generateAnchors();
+
+            cv::Rect2f decodeBox(const float* rawBoxes, int index) const;
+
+        private:
+            std::vector<cv::Point2f> m_anchors;
+            std::vector<Detection> m_detections;
+            cv::Size m_imageSize;
+            int m_boxesIndex;
+            int m_scoresIndex;
+            int m_inputSize;
+    };
+}
+
+#endif // FACEDETECTION_H
@@ -0,0 +1,185 @@
+#include "FrameConvert.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/*
+Source samples of one output column (or row).
+i0 / i1 are the two pixels blended with weight w1 on i1,
+inside is false when the output pixel falls out of the frame.
+*/
+struct Tap {
+    int i0;
+    int i1;
+    float w1;
+    bool inside;
+
+    /*
+    Pixel used for chroma (subsampled, nearest is enough)
+    */
+    int nearest() const { return w1 < 0.5f ? i0 : i1; }
+};
+
+
+/*
+Helper function: sampling positions along one axis, same pixel centers as cv::resize.
+start / length: roi along the axis (seen coordinates), srcLength: frame size.
+*/
+static std::vector<Tap> __computeTaps(int start, int length, int outLength, int srcLength, bool mirror) {
+    std::vector<Tap> taps(outLength);
+    float scale = (float)length / outLength;
+
+    for (int d = 0; d < outLength; ++d) {
+        float s = start + (d + 0.5f) * scale - 0.5f;
+        int nearest = (int)std::floor(s + 0.5f);
+
+        Tap& tap = taps[d];
+        tap.inside = nearest >= 0 && nearest < srcLength;
+
+        s = std::min(std::max(s, 0.f), (float)(srcLength - 1));
+        tap.i0 = (int)s;
+        tap.i1 = std::min(tap.i0 + 1, srcLength - 1);
+        tap.w1 = s - tap.i0;
+
+        if (mirror) {
+            tap.i0 = srcLength - 1 - tap.i0;
+            tap.i1 = srcLength - 1 - tap.i1;
+        }
+    }
+    return taps;
+}
+
+
+static inline float __lerp(float a, float b, float w) {
+    return a + (b - a) * w;
+}
+
+
+static inline float __clamp255(float v) {
+    return std::min(std::max(v, 0.f), 255.f);
+}
+
+
+/*
+BT.601 limited range, the same conversion as cv::COLOR_YUV2RGB_*.
+red / blue: position of the red and blue channels in out.
+*/
+template <class T>
+static inline void __yuvToRgb(float y, int u, int v, float scale, float offset, int red, int blue, T* out) {
+    float c = 1.164f * (y - 16.f);
+    float d = (float)(u - 128);
+    float e = (float)(v - 128);
+
+    out[red] = cv::saturate_cast<T>(__clamp255(c + 1.596f * e) * scale + offset);
+    out[1] = cv::saturate_cast<T>(__clamp255(c - 0.392f * d - 0.813f * e) * scale + offset);
+    out[blue] = cv::saturate_cast<T>(__clamp255(c + 2.017f * d) * scale + offset);
+}
+
+
+/*
+Body of frameToTensor() / frameToBytes(): T is the tensor type,
+rgb selects the channel order of dst.
+*/
+template <class T>
+static void __sampleFrame(const hand::Frame& frame, cv::Rect roi, T* dst, int width, int height,
+                          float scale, float offset, bool rgb) {
+    using hand::PixelFormat;
+    const cv::Size size = frame.size();
+    if (roi.empty())
+        roi = cv::Rect(cv::Point(0, 0), size);
+
+    const std::vector<Tap> xTaps = __computeTaps(roi.x, roi.width, width, size.width, frame.mirrored);
+    const std::vector<Tap> yTaps = __computeTaps(roi.y, roi.height, height, size.height, false);
+
+    const int red = rgb ? 0 : 2;
+    const int blue = 2 - red;
+    const T padding = cv::saturate_cast<T>(offset);
+
+    cv::parallel_for_(cv::Range(0, height), [&](const cv::Range& range) {
+        for (int dy = range.start; dy < range.end; ++dy) {
+            const Tap& ty = yTaps[dy];
+            T* out = dst + (size_t)dy * width * 3;
+
+            if (ty.inside == false) {
+                std::fill(out, out + width * 3, padding);
+                continue;
+            }
+
+            switch (frame.format) {
+                case PixelFormat::YUYV: {
+                    const uchar* row0 = frame.data.ptr<uchar>(ty.i0);
+                    const uchar* row1 = frame.data.ptr<uchar>(ty.i1);
+                    const uchar* chromaRow = frame.data.ptr<uchar>(ty.nearest());
+
+                    for (int dx = 0; dx < width; ++dx, out += 3) {
+                        const Tap& tx = xTaps[dx];
+                        if (tx.inside == false) {
+                            out[0] = out[1] = out[2] = padding;
+                            continue;
+                        }
+                        float top = __lerp(row0[tx.i0 * 2], row0[tx.i1 * 2], tx.w1);
+                        float bottom = __lerp(row1[tx.i0 * 2], row1[tx.i1 * 2], tx.w1);
+                        const uchar* uyvy = chromaRow + (tx.nearest() & ~1) * 2;
+                        __yuvToRgb(__lerp(top, bottom, ty.w1), uyvy[1], uyvy[3], scale, offset, red, blue, out);
+                    }
+                    break;
+                }
+                case PixelFormat::NV12: {
+                    const uchar* row0 = frame.data.ptr<uchar>(ty.i0);
+                    const uchar* row1 = frame.data.ptr<uchar>(ty.i1);
+                    const uchar* uvRow = frame.data.ptr<uchar>(size.height + ty.nearest() / 2);
+
+                    for (int dx = 0; dx < width; ++dx, out += 3) {
+                        const Tap& tx = xTaps[dx];
+                        if (tx.inside == false) {
+                            out[0] = out[1] = out[2] = padding;
+                            continue;
+                        }
+                        float top = __lerp(row0[tx.i0], row0[tx.i1], tx.w1);
+                        float bottom = __lerp(row1[tx.i0], row1[tx.i1], tx.w1);
+                        const uchar* uv = uvRow + (tx.nearest() & ~1);
+                        __yuvToRgb(__lerp(top, bottom, ty.w1), uv[0], uv[1], scale, offset, red, blue, out);
+                    }
+                    break;
+                }
+                default: {
+                    const uchar* row0 = frame.data.ptr<uchar>(ty.i0);
+                    const uchar* row1 = frame.data.ptr<uchar>(ty.i1);
+
+                    for (int dx = 0; dx < width; ++dx, out += 3) {
+                        const Tap& tx = xTaps[dx];
+                        if (tx.inside == false) {
+                            out[0] = out[1] = out[2] = padding;
+                            continue;
+                        }
+                        /*
+                        BGR in, channel c of out is channel src of the frame
+                        */
+                        for (int c = 0; c < 3; ++c) {
+                            int src = rgb ? 2 - c : c;
+                            float top = __lerp(row0[tx.i0 * 3 + src], row0[tx.i1 * 3 + src], tx.w1);
+                            float bottom = __lerp(row1[tx.i0 * 3 + src], row1[tx.i1 * 3 + src], tx.w1);
+                            out[c] = cv::saturate_cast<T>(__lerp(top, bottom, ty.w1) * scale + offset);
+                        }
+                    }
+                    break;
+                }
+            }
+        }
+    });
+}
+
+
+void hand::frameToTensor(const Frame& frame, cv::Rect roi, float* dst, int width, int height,
+                         float mean, float std) {
+    /*
+    Equivalent to (value - mean) / std, black is the padding value
+    */
+    __sampleFrame(frame, roi, dst, width, height, 1.f / std, -mean / std, true);
+}
+
+
+void hand::frameToBytes(const Frame& frame, cv::Rect roi, uchar* dst, int width, int height) {
+    __sampleFrame(frame, roi, dst, width, height, 1.f, 0.f, false);
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef FRAMECONVERT_H
+#define FRAMECONVERT_H
+
+#include "FrameSource.hpp"
+
+namespace hand {
+
+    /*
+    Write roi of frame, resized (bilinear) to width x height, into dst as
+    interleaved RGB floats normalized with (value - mean) / std.
+    roi is in the coordinates of the image as seen (after the mirror) and
+    may go out of the frame: outside pixels are black, like
+    HandDetection::cropFrame(). An empty roi means the whole frame.
+
+    YUYV and NV12 are converted (BT.601) while sampling, so crop, resize,
+    color conversion and normalization are one pass over the output
+    pixels, with no full size intermediate image.
+    */
+    void frameToTensor(const Frame& frame, cv::Rect roi, float* dst, int width, int height,
+                       float mean, float std);
+
+    /*
+    Same as frameToTensor() for models taking raw bytes (see ModelLoader::isRawInput()):
+    interleaved BGR uint8, no normalization.
+    */
+    void frameToBytes(const Frame& frame, cv::Rect roi, uchar* dst, int width, int height);
+}
+
+#endif // FRAMECONVERT_H
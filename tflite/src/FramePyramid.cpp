@@ -0,0 +1,84 @@
+#include "FramePyramid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "opencv2/imgproc.hpp"
+
+
+hand::FramePyramid::FramePyramid() : m_levels(FRAME_PYRAMID_MAX_LEVELS), m_built(0) {}
+
+
+void hand::FramePyramid::reset(const cv::Mat& image) {
+    /*
+    Buffers of the coarser levels are kept: same size frames reuse them.
+    */
+    m_levels[0] = image;
+    m_built = image.empty() ? 0 : 1;
+}
+
+
+bool hand::FramePyramid::empty() const {
+    return m_built == 0;
+}
+
+
+const cv::Mat& hand::FramePyramid::getLevel(int level) {
+    level = std::min(std::max(level, 0), FRAME_PYRAMID_MAX_LEVELS - 1);
+    if (m_built == 0)
+        return m_levels[0];
+
+    for (; m_built <= level; ++m_built) {
+        cv::resize(m_levels[m_built - 1], m_levels[m_built], getLevelSize(m_built), 0, 0, cv::INTER_AREA);
+    }
+    return m_levels[level];
+}
+
+
+int hand::FramePyramid::findLevel(const cv::Size& wanted, cv::Rect region) const {
+    if (m_built == 0)
+        return 0;
+    if (region.empty())
+        region = cv::Rect(cv::Point(0, 0), m_levels[0].size());
+
+    int level = 0;
+    while (level + 1 < FRAME_PYRAMID_MAX_LEVELS) {
+        cv::Rect next = toLevel(region, level + 1);
+        if (next.width < wanted.width || next.height < wanted.height)
+            break;
+        level++;
+    }
+    return level;
+}
+
+
+cv::Rect hand::FramePyramid::toLevel(const cv::Rect& rect, int level) const {
+    if (level <= 0 || m_built == 0)
+        return rect;
+
+    cv::Size size0 = m_levels[0].size();
+    cv::Size size = getLevelSize(level);
+    double sx = (double)size.width / size0.width;
+    double sy = (double)size.height / size0.height;
+
+    int x = (int)std::floor(rect.x * sx);
+    int y = (int)std::floor(rect.y * sy);
+    return cv::Rect(x, y,
+                    std::max(1, (int)std::ceil(rect.br().x * sx) - x),
+                    std::max(1, (int)std::ceil(rect.br().y * sy) - y));
+}
+
+
+int hand::FramePyramid::getNumberOfBuiltLevels() const {
+    return m_built;
+}
+
+//-------------------Private methods start here-------------------
+
+cv::Size hand::FramePyramid::getLevelSize(int level) const {
+    cv::Size size = m_levels[0].size();
+    for (int i = 0; i < level; ++i) {
+        size = cv::Size((size.width + 1) / 2, (size.height + 1) / 2);
+    }
+    return size;
+}
@@ -0,0 +1,63 @@
+#ifndef FRAMEPYRAMID_H
+#define FRAMEPYRAMID_H
+
+#include <vector>
+
+#include "opencv2/core.hpp"
+
+#define FRAME_PYRAMID_MAX_LEVELS    6   // Level 5 is 1/32 of the frame (60x34 at 1080p)
+
+namespace hand {
+
+    /*
+    Halved copies of one frame (level 0 = the frame, level k = 1/2^k),
+    each built on first use from the level above (INTER_AREA) and kept
+    until the next reset(). Model inputs are resized from the smallest
+    level still at least as large as the input, so the final resize only
+    ever works on a few times the input size whatever the camera resolution.
+    Levels are only built when a stage asks for them.
+    */
+    class FramePyramid {
+        public:
+            FramePyramid();
+
+            /*
+            Start a new frame. image is not copied (level 0 is a header on it).
+            */
+            void reset(const cv::Mat& image);
+
+            bool empty() const;
+
+            /*
+            Image at level, built (with the levels above it) if needed.
+            level is clamped to [0, FRAME_PYRAMID_MAX_LEVELS - 1].
+            */
+            const cv::Mat& getLevel(int level);
+
+            /*
+            Coarsest level at which region (level 0 pixels) still covers at least
+            wanted pixels, i.e. the level to crop region from before resizing it to wanted.
+            An empty region means the whole frame.
+            */
+            int findLevel(const cv::Size& wanted, cv::Rect region = cv::Rect()) const;
+
+            /*
+            Map a rectangle of level 0 to level.
+            */
+            cv::Rect toLevel(const cv::Rect& rect, int level) const;
+
+            /*
+            Number of levels built for the current frame
+            */
+            int getNumberOfBuiltLevels() const;
+
+        private:
+            cv::Size getLevelSize(int level) const;
+
+        private:
+            std::vector<cv::Mat> m_levels;
+            int m_built;
+    };
+}
+
+#endif // FRAMEPYRAMID_H
@@ -0,0 +1,150 @@
+#include "FrameScheduler.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#define COST_SMOOTHING 0.2
+
+
+hand::FrameScheduler::FrameScheduler(int maxQueuedPerStream) :
+    m_maxQueued(std::max(maxQueuedPerStream, 1)), m_costMs{0.0, 0.0}
+{}
+
+
+int hand::FrameScheduler::addStream() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_streams.emplace_back();
+    return m_streams.size() - 1;
+}
+
+
+void hand::FrameScheduler::push(FrameJob job) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (isIdValid(job.streamId) == false)
+        return;
+
+    StreamQueue& queue = m_streams[job.streamId];
+    queue.stats.queued++;
+    if ((int)queue.frames.size() >= m_maxQueued) {
+        queue.frames.pop_front();
+        queue.stats.dropped++;
+    }
+    queue.frames.push_back(std::move(job));
+}
+
+
+bool hand::FrameScheduler::pop(FrameJob& job) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto now = Clock::now();
+
+    int best = -1;
+    JobKind bestKind = JobKind::Detect;
+    for (int i = 0; i < (int)m_streams.size(); ++i) {
+        StreamQueue& queue = m_streams[i];
+        if (queue.inFlight)
+            continue;
+
+        skipHopelessFrames(queue, now);
+        if (queue.frames.empty())
+            continue;
+
+        JobKind kind = getNextKind(queue);
+        if (best == -1 || queue.frames.front().deadline < m_streams[best].frames.front().deadline ||
+           (queue.frames.front().deadline == m_streams[best].frames.front().deadline && kind < bestKind)) {
+            best = i;
+            bestKind = kind;
+        }
+    }
+    if (best == -1)
+        return false;
+
+    StreamQueue& queue = m_streams[best];
+    job = std::move(queue.frames.front());
+    queue.frames.pop_front();
+    queue.inFlight = true;
+
+    job.kind = bestKind;
+    job.trackRoi = queue.trackRoi;
+    if (bestKind == JobKind::Track)
+        queue.stats.tracked++;
+    return true;
+}
+
+
+void hand::FrameScheduler::complete(const FrameJob& job, double inferenceMs, const cv::Rect& nextTrackRoi) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (isIdValid(job.streamId) == false)
+        return;
+
+    double& cost = m_costMs[(int)job.kind];
+    cost = (cost == 0.0) ? inferenceMs : cost + COST_SMOOTHING * (inferenceMs - cost);
+
+    StreamQueue& queue = m_streams[job.streamId];
+    if (Clock::now() > job.deadline)
+        queue.stats.late++;
+
+    queue.trackRoi = nextTrackRoi;
+    queue.inFlight = false;
+}
+
+
+bool hand::FrameScheduler::hasRunnable() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& queue : m_streams) {
+        if (queue.inFlight == false && queue.frames.empty() == false)
+            return true;
+    }
+    return false;
+}
+
+
+hand::SchedulerStats hand::FrameScheduler::getStats(int streamId) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (isIdValid(streamId) == false)
+        return SchedulerStats();
+
+    return m_streams[streamId].stats;
+}
+
+
+double hand::FrameScheduler::getExpectedCostMs(JobKind kind) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_costMs[(int)kind];
+}
+
+//-------------------Private methods start here-------------------
+
+void hand::FrameScheduler::skipHopelessFrames(StreamQueue& queue, Clock::time_point now) {
+    auto cost = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(m_costMs[(int)getNextKind(queue)]));
+
+    while (queue.frames.empty() == false) {
+        const FrameJob& head = queue.frames.front();
+        bool isNewest = (queue.frames.size() == 1);
+        bool expired = (now >= head.deadline);
+        bool wouldMiss = (now + cost > head.deadline);
+
+        if (expired || (wouldMiss && isNewest == false)) {
+            queue.frames.pop_front();
+            queue.stats.skipped++;
+        }
+        else {
+            break;
+        }
+    }
+}
+
+
+hand::JobKind hand::FrameScheduler::getNextKind(const StreamQueue& queue) const {
+    return queue.trackRoi.empty() ? JobKind::Detect : JobKind::Track;
+}
+
+
+bool hand::FrameScheduler::isIdValid(int streamId) const {
+    if (streamId < 0 || streamId >= (int)m_streams.size()) {
+        std::cerr << "Stream " << streamId << " is out of range (" \
+        << m_streams.size() << ")." << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,150 @@
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "opencv2/core.hpp"
+
+namespace hand {
+
+    using Clock = std::chrono::steady_clock;
+
+    /*
+    What a frame needs from a session.
+    Track: the stream follows a hand, only the landmark model runs on its roi.
+    Detect: no hand is tracked, palm detection then landmarks.
+    Track jobs are cheaper: they win a tie of deadlines.
+    */
+    enum class JobKind {
+        Track = 0,
+        Detect = 1
+    };
+
+    /*
+    A frame waiting for inference.
+    Attributes:
+        captureTime: when the frame was read from the source
+        deadline: the result is useless after this point
+        kind, trackRoi: decided by the scheduler from the tracking state of the stream
+    */
+    struct FrameJob {
+        int streamId = -1;
+        size_t frameIndex = 0;
+        cv::Mat frame;
+        Clock::time_point captureTime;
+        Clock::time_point deadline;
+        JobKind kind = JobKind::Detect;
+        cv::Rect trackRoi;
+    };
+
+    /*
+    Scheduler counters of a single stream.
+    Attributes:
+        queued: frames pushed
+        dropped: frames pushed out of a full queue by newer ones
+        skipped: frames not run because they would have missed their deadline
+        late: frames which were run but completed after their deadline
+        tracked: frames run as JobKind::Track
+    */
+    struct SchedulerStats {
+        size_t queued = 0;
+        size_t dropped = 0;
+        size_t skipped = 0;
+        size_t late = 0;
+        size_t tracked = 0;
+
+        size_t getDeadlineMisses() const { return skipped + late; }
+    };
+
+    /*
+    Deadline-aware frame queue shared by several streams.
+
+    pop() returns, among the streams without a frame in flight, the job of
+    earliest deadline; Track goes before Detect only on equal deadlines, so a
+    stream following a hand never starves one waiting for a detection.
+    A frame is skipped BEFORE inference when now + expected cost of its kind
+    exceeds its deadline. The newest frame of a stream is still run while its
+    deadline has not passed, so an overloaded system degrades to fewer, late
+    results per stream instead of none.
+
+    Expected costs are running averages of the durations given to complete().
+    This class is thread-safe.
+    */
+    class FrameScheduler {
+        public:
+            /*
+            Parameters:
+                maxQueuedPerStream: older frames are dropped beyond this
+            */
+            FrameScheduler(int maxQueuedPerStream = 2);
+
+            /*
+            Register a stream, return its id for push().
+            */
+            int addStream();
+
+            /*
+            Queue a frame. streamId, captureTime and deadline MUST be set.
+            */
+            void push(FrameJob job);
+
+            /*
+            Take the next job to run, return false if no stream has a runnable frame.
+            The stream of the job stays busy until complete() is called.
+            */
+            bool pop(FrameJob& job);
+
+            /*
+            Report the end of a job returned by pop().
+            Parameters:
+                inferenceMs: time spent inside the session
+                nextTrackRoi: roi to track on the next frame (empty: run detection)
+            */
+            void complete(const FrameJob& job, double inferenceMs, const cv::Rect& nextTrackRoi);
+
+            /*
+            True if pop() would find a frame.
+            */
+            bool hasRunnable() const;
+
+            SchedulerStats getStats(int streamId) const;
+
+            /*
+            Get the running average duration of a job of this kind.
+            */
+            double getExpectedCostMs(JobKind kind) const;
+
+        private:
+            struct StreamQueue {
+                std::deque<FrameJob> frames;
+                bool inFlight = false;
+                cv::Rect trackRoi;
+                SchedulerStats stats;
+            };
+
+            /*
+            Remove the frames of queue which cannot meet their deadline anymore.
+            */
+            void skipHopelessFrames(StreamQueue& queue, Clock::time_point now);
+
+            JobKind getNextKind(const StreamQueue& queue) const;
+
+            bool isIdValid(int streamId) const;
+
+        private:
+            int m_maxQueued;
+            std::vector<StreamQueue> m_streams;
+
+            /*
+            Running average cost per JobKind, 0 until the first complete()
+            */
+            double m_costMs[2];
+
+            mutable std::mutex m_mutex;
+    };
+}
+
+#endif // FRAMESCHEDULER_H
@@ -0,0 +1,111 @@
+#include "FrameSource.hpp"
+#include "FrameConvert.hpp"
+
+#include <chrono>
+#include <iostream>
+
+#include "opencv2/imgproc.hpp"
+
+
+cv::Size hand::Frame::size() const {
+    if (format == PixelFormat::NV12)
+        return cv::Size(data.cols, data.rows * 2 / 3);
+
+    return data.size();
+}
+
+
+bool hand::Frame::empty() const {
+    return data.empty();
+}
+
+
+void hand::FrameSource::toBGR(const Frame& frame, cv::Mat& out) {
+    /*
+    Mirrored frames are converted and flipped in one pass over the output
+    */
+    if (frame.mirrored) {
+        cv::Size size = frame.size();
+        if (frame.format == PixelFormat::BGR) {
+            cv::flip(frame.data, out, 1);
+            return;
+        }
+        if (out.isContinuous() == false)
+            out.release();
+        out.create(size, CV_8UC3);
+        frameToBytes(frame, cv::Rect(), out.ptr<uchar>(), size.width, size.height);
+        return;
+    }
+
+    switch (frame.format) {
+        case PixelFormat::YUYV:
+            cv::cvtColor(frame.data, out, cv::COLOR_YUV2BGR_YUYV);
+            break;
+        case PixelFormat::NV12:
+            cv::cvtColor(frame.data, out, cv::COLOR_YUV2BGR_NV12);
+            break;
+        default:
+            frame.data.copyTo(out);
+            break;
+    }
+}
+
+
+size_t hand::FrameSource::frameBytes(PixelFormat format, const cv::Size& size) {
+    size_t pixels = (size_t)size.width * size.height;
+    switch (format) {
+        case PixelFormat::YUYV: return pixels * 2;
+        case PixelFormat::NV12: return pixels * 3 / 2;
+        default:                return pixels * 3;
+    }
+}
+
+
+hand::RawFileSource::RawFileSource(const std::string& path, PixelFormat format, cv::Size size, bool mirror) :
+    m_file(path, std::ios::binary), m_format(format), m_size(size), m_mirror(mirror), m_sequence(0)
+{
+    if (m_file.is_open() == false) {
+        std::cerr << "Fail to open raw frames: " << path << std::endl;
+        return;
+    }
+
+    switch (m_format) {
+        case PixelFormat::YUYV:
+            m_buffer.create(m_size, CV_8UC2);
+            break;
+        case PixelFormat::NV12:
+            m_buffer.create(m_size.height * 3 / 2, m_size.width, CV_8UC1);
+            break;
+        default:
+            m_buffer.create(m_size, CV_8UC3);
+            break;
+    }
+}
+
+
+bool hand::RawFileSource::isOpened() const {
+    return m_file.is_open();
+}
+
+
+bool hand::RawFileSource::read(Frame& frame) {
+    if (m_file.is_open() == false)
+        return false;
+
+    size_t bytes = frameBytes(m_format, m_size);
+    if (m_file.read((char*)m_buffer.data, bytes).gcount() != (std::streamsize)bytes)
+        return false;
+
+    frame.data = m_buffer;
+    frame.format = m_format;
+    frame.mirrored = m_mirror;
+    frame.sequence = m_sequence++;
+    frame.timeMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return true;
+}
+
+
+void hand::RawFileSource::release() {
+    m_file.close();
+}
@@ -0,0 +1,99 @@
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+#include <fstream>
+#include <string>
+
+#include "opencv2/core.hpp"
+
+namespace hand {
+
+    enum class PixelFormat {
+        BGR = 0,    // CV_8UC3
+        YUYV,       // packed 4:2:2, CV_8UC2 (Y0 U Y1 V)
+        NV12        // planar Y + interleaved UV 4:2:0, CV_8UC1 of rows * 3 / 2
+    };
+
+    /*
+    A captured frame in the format delivered by the source.
+    Attributes:
+        data: pixels, may point into the source's buffers (see FrameSource::read())
+        format: layout of data
+        mirrored: the frame must be seen flipped horizontally; converters read it
+                  mirrored, so no flipped copy is ever made
+        sequence: frame counter of the source
+        timeMs: capture time (steady clock)
+    */
+    struct Frame {
+        cv::Mat data;
+        PixelFormat format = PixelFormat::BGR;
+        bool mirrored = false;
+        size_t sequence = 0;
+        double timeMs = 0.0;
+
+        /*
+        Size of the image (NV12 data holds the chroma plane below the luma).
+        */
+        cv::Size size() const;
+        bool empty() const;
+    };
+
+    /*
+    A capture backend delivering Frame.
+    */
+    class FrameSource {
+        public:
+            virtual ~FrameSource() = default;
+
+            virtual bool isOpened() const = 0;
+
+            /*
+            Grab the next frame. frame.data may be a header on the source's
+            own buffers: it is only valid until the next read() or release().
+            Return false at the end of the stream or on error.
+            */
+            virtual bool read(Frame& frame) = 0;
+
+            virtual void release() = 0;
+
+            /*
+            Convert frame to a BGR image (applying the mirror), for display
+            and the OpenCV based trackers. A mirrored frame is converted and
+            flipped in the same pass (frameToBytes()).
+            */
+            static void toBGR(const Frame& frame, cv::Mat& out);
+
+            /*
+            Bytes of one frame of format and size.
+            */
+            static size_t frameBytes(PixelFormat format, const cv::Size& size);
+    };
+
+    /*
+    Replay raw frames recorded back to back in a file,
+    e.g. v4l2-ctl --stream-mmap --stream-to=hand.yuyv.
+    Lets the YUV path run without a camera.
+    This class is non-copyable.
+    */
+    class RawFileSource : public FrameSource {
+        public:
+            RawFileSource(const std::string& path, PixelFormat format, cv::Size size, bool mirror = true);
+            RawFileSource(const RawFileSource& other) = delete;
+            RawFileSource& operator=(const RawFileSource& other) = delete;
+            virtual ~RawFileSource() = default;
+
+            virtual bool isOpened() const;
+            virtual bool read(Frame& frame);
+            virtual void release();
+
+        private:
+            std::ifstream m_file;
+            PixelFormat m_format;
+            cv::Size m_size;
+            bool m_mirror;
+            size_t m_sequence;
+            cv::Mat m_buffer;
+    };
+}
+
+#endif // FRAMESOURCE_H
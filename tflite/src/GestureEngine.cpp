@@ -0,0 +1,303 @@
+#include "GestureEngine.hpp"
+
+#include <chrono>
+#include <cmath>
+
+/*
+Mediapipe hand landmark indices
+*/
+#define LM_WRIST        0
+#define LM_THUMB_IP     3
+#define LM_THUMB_TIP    4
+#define LM_INDEX_MCP    5
+#define LM_INDEX_TIP    8
+#define LM_MIDDLE_MCP   9
+#define LM_RING_MCP     13
+#define LM_PINKY_MCP    17
+
+#define GESTURE_IDLE_SLEEP_MS   1   // Consumer sleep when the ring is empty
+
+
+static float distance(const cv::Point2f& a, const cv::Point2f& b) {
+    return std::hypot(a.x - b.x, a.y - b.y);
+}
+
+
+hand::GestureEngine::GestureEngine() :
+    m_running(false), m_submitted(0), m_droppedSamples(0), m_emitted(0), m_droppedEvents(0),
+    m_trackCount(0), m_lastSwipeMs(-1e9),
+    m_pinched(false), m_pinchVotes(0),
+    m_fingers(-1), m_fingerCandidate(-1), m_fingerVotes(0), m_stopped(false)
+{}
+
+
+hand::GestureEngine::~GestureEngine() {
+    stop();
+}
+
+
+void hand::GestureEngine::start() {
+    if (m_running)
+        return;
+    m_running = true;
+    m_thread = std::thread(&GestureEngine::run, this);
+}
+
+
+void hand::GestureEngine::stop() {
+    m_running = false;
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+
+bool hand::GestureEngine::submit(const std::vector<cv::Point>& landmarks, float presence, double timeMs) {
+    LandmarkSample sample;
+    sample.timeMs = timeMs < 0 ? now() : timeMs;
+    sample.presence = presence;
+    sample.valid = landmarks.size() >= GESTURE_NUM_LANDMARKS;
+    if (sample.valid) {
+        for (int i = 0; i < GESTURE_NUM_LANDMARKS; ++i) {
+            sample.points[i] = landmarks[i];
+        }
+    }
+
+    m_submitted++;
+    if (m_samples.push(sample) == false) {
+        m_droppedSamples++;
+        return false;
+    }
+    return true;
+}
+
+
+bool hand::GestureEngine::pollEvent(GestureEvent& event) {
+    return m_events.pop(event);
+}
+
+
+hand::GestureEngineStats hand::GestureEngine::getStats() const {
+    GestureEngineStats stats;
+    stats.samples = m_submitted;
+    stats.droppedSamples = m_droppedSamples;
+    stats.events = m_emitted;
+    stats.droppedEvents = m_droppedEvents;
+    return stats;
+}
+
+
+double hand::GestureEngine::now() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+const char* hand::GestureEngine::toString(GestureType type) {
+    switch (type) {
+        case GestureType::SwipeLeft:   return "Swipe left";
+        case GestureType::SwipeRight:  return "Swipe right";
+        case GestureType::SwipeUp:     return "Swipe up";
+        case GestureType::SwipeDown:   return "Swipe down";
+        case GestureType::PinchStart:  return "Pinch";
+        case GestureType::PinchEnd:    return "Pinch release";
+        case GestureType::PalmStop:    return "Stop";
+        case GestureType::FingerCount: return "Fingers";
+    }
+    return "";
+}
+
+//-------------------Private methods start here-------------------
+
+void hand::GestureEngine::run() {
+    LandmarkSample sample;
+    while (m_running) {
+        if (m_samples.pop(sample) == false) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(GESTURE_IDLE_SLEEP_MS));
+            continue;
+        }
+        process(sample);
+    }
+}
+
+
+void hand::GestureEngine::process(const LandmarkSample& sample) {
+    if (sample.valid == false) {
+        /*
+        Hand lost: close the pinch, forget the trajectory and the count
+        */
+        if (m_pinched)
+            emit(GestureType::PinchEnd, sample.timeMs);
+        m_pinched = false;
+        m_pinchVotes = 0;
+        m_fingers = -1;
+        m_fingerCandidate = -1;
+        m_fingerVotes = 0;
+        m_stopped = false;
+        resetTrack();
+        return;
+    }
+
+    const auto& p = sample.points;
+    TrackPoint point;
+    point.timeMs = sample.timeMs;
+    point.palm = (p[LM_WRIST] + p[LM_INDEX_MCP] + p[LM_MIDDLE_MCP] + p[LM_RING_MCP] + p[LM_PINKY_MCP]) / 5.f;
+    point.handSize = distance(p[LM_WRIST], p[LM_MIDDLE_MCP]);
+    if (point.handSize < 1.f)
+        return;
+
+    m_track[m_trackCount % GESTURE_WINDOW] = point;
+    m_trackCount++;
+
+    bool swiped = detectSwipe(sample);
+    detectPinch(sample);
+    detectFingersAndStop(sample);
+
+    /*
+    A new trajectory starts after a swipe
+    */
+    if (swiped)
+        resetTrack();
+}
+
+
+void hand::GestureEngine::emit(GestureType type, double timeMs, int fingers) {
+    GestureEvent event;
+    event.type = type;
+    event.timeMs = timeMs;
+    event.fingers = fingers;
+
+    if (m_events.push(event))
+        m_emitted++;
+    else
+        m_droppedEvents++;
+}
+
+
+void hand::GestureEngine::resetTrack() {
+    m_trackCount = 0;
+}
+
+
+int hand::GestureEngine::countFingers(const LandmarkSample& sample) {
+    const auto& p = sample.points;
+    int count = 0;
+
+    /*
+    A finger is extended when its tip is farther from the wrist than its PIP joint.
+    */
+    for (int tip = LM_INDEX_TIP; tip < GESTURE_NUM_LANDMARKS; tip += 4) {
+        if (distance(p[tip], p[LM_WRIST]) > distance(p[tip - 2], p[LM_WRIST]))
+            count++;
+    }
+
+    /*
+    The thumb folds across the palm: compare with the pinky base instead.
+    */
+    if (distance(p[LM_THUMB_TIP], p[LM_PINKY_MCP]) > distance(p[LM_THUMB_IP], p[LM_PINKY_MCP]))
+        count++;
+
+    return count;
+}
+
+
+bool hand::GestureEngine::detectSwipe(const LandmarkSample& sample) {
+    if (sample.timeMs - m_lastSwipeMs < GESTURE_SWIPE_COOLDOWN_MS)
+        return false;
+
+    const size_t available = std::min<size_t>(m_trackCount, GESTURE_WINDOW);
+    if (available < GESTURE_DEBOUNCE_FRAMES)
+        return false;
+
+    const TrackPoint& current = m_track[(m_trackCount - 1) % GESTURE_WINDOW];
+
+    /*
+    Oldest point of the window still inside GESTURE_SWIPE_MS
+    */
+    const TrackPoint* oldest = &current;
+    for (size_t i = 2; i <= available; ++i) {
+        const TrackPoint& point = m_track[(m_trackCount - i) % GESTURE_WINDOW];
+        if (current.timeMs - point.timeMs > GESTURE_SWIPE_MS)
+            break;
+        oldest = &point;
+    }
+
+    cv::Point2f move = current.palm - oldest->palm;
+    float length = std::hypot(move.x, move.y) / current.handSize;
+    if (length < GESTURE_SWIPE_DISTANCE)
+        return false;
+
+    /*
+    Only clear horizontal or vertical moves
+    */
+    GestureType type;
+    if (std::abs(move.x) > 2.f * std::abs(move.y))
+        type = move.x > 0 ? GestureType::SwipeRight : GestureType::SwipeLeft;
+    else if (std::abs(move.y) > 2.f * std::abs(move.x))
+        type = move.y > 0 ? GestureType::SwipeDown : GestureType::SwipeUp;
+    else
+        return false;
+
+    emit(type, sample.timeMs);
+    m_lastSwipeMs = sample.timeMs;
+    return true;
+}
+
+
+void hand::GestureEngine::detectPinch(const LandmarkSample& sample) {
+    const TrackPoint& current = m_track[(m_trackCount - 1) % GESTURE_WINDOW];
+    float gap = distance(sample.points[LM_THUMB_TIP], sample.points[LM_INDEX_TIP]) / current.handSize;
+
+    bool pinched = m_pinched ? gap < GESTURE_PINCH_OFF : gap < GESTURE_PINCH_ON;
+    if (pinched == m_pinched) {
+        m_pinchVotes = 0;
+        return;
+    }
+
+    if (++m_pinchVotes >= GESTURE_DEBOUNCE_FRAMES) {
+        m_pinched = pinched;
+        m_pinchVotes = 0;
+        emit(pinched ? GestureType::PinchStart : GestureType::PinchEnd, sample.timeMs);
+    }
+}
+
+
+void hand::GestureEngine::detectFingersAndStop(const LandmarkSample& sample) {
+    int fingers = countFingers(sample);
+    if (fingers == m_fingerCandidate) {
+        m_fingerVotes++;
+    }
+    else {
+        m_fingerCandidate = fingers;
+        m_fingerVotes = 1;
+    }
+
+    if (m_fingerVotes >= GESTURE_DEBOUNCE_FRAMES && m_fingerCandidate != m_fingers) {
+        m_fingers = m_fingerCandidate;
+        emit(GestureType::FingerCount, sample.timeMs, m_fingers);
+    }
+
+    if (m_fingers != 5) {
+        m_stopped = false;
+        return;
+    }
+    if (m_stopped)
+        return;
+
+    /*
+    Open hand: a stop if the palm stayed within GESTURE_STOP_MOTION for GESTURE_STOP_MS.
+    */
+    const size_t available = std::min<size_t>(m_trackCount, GESTURE_WINDOW);
+    const TrackPoint& current = m_track[(m_trackCount - 1) % GESTURE_WINDOW];
+    const float maxMove = GESTURE_STOP_MOTION * current.handSize;
+
+    for (size_t i = 2; i <= available; ++i) {
+        const TrackPoint& point = m_track[(m_trackCount - i) % GESTURE_WINDOW];
+        if (distance(point.palm, current.palm) > maxMove)
+            return;
+
+        if (current.timeMs - point.timeMs >= GESTURE_STOP_MS) {
+            m_stopped = true;
+            emit(GestureType::PalmStop, sample.timeMs, m_fingers);
+            return;
+        }
+    }
+}
@@ -0,0 +1,165 @@
+#ifndef GESTUREENGINE_H
+#define GESTUREENGINE_H
+
+#include "SpscRing.hpp"
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "opencv2/core.hpp"
+
+#define GESTURE_NUM_LANDMARKS       21
+#define GESTURE_WINDOW              32      // Samples kept in the trajectory window (power of two)
+#define GESTURE_QUEUE_SIZE          64      // Landmark samples / events in flight (power of two)
+#define GESTURE_DEBOUNCE_FRAMES     3       // A state must hold this many samples before it is reported
+
+#define GESTURE_SWIPE_MS            400.0   // A swipe is a move done within this time
+#define GESTURE_SWIPE_DISTANCE      1.5f    // Swipe length, in hand sizes (wrist to middle finger base)
+#define GESTURE_SWIPE_COOLDOWN_MS   600.0   // No other swipe right after one
+#define GESTURE_PINCH_ON            0.25f   // Thumb-index tips distance (hand sizes) to start a pinch
+#define GESTURE_PINCH_OFF           0.40f   // ... and to release it
+#define GESTURE_STOP_MS             400.0   // An open hand held still this long is a stop
+#define GESTURE_STOP_MOTION         0.15f   // Max palm move (hand sizes) while holding still
+
+namespace hand {
+
+    enum class GestureType {
+        SwipeLeft = 0,
+        SwipeRight,
+        SwipeUp,
+        SwipeDown,
+        PinchStart,
+        PinchEnd,
+        PalmStop,
+        FingerCount
+    };
+
+    /*
+    Attributes:
+        timeMs: timestamp of the landmark sample which triggered it
+        fingers: extended fingers (FingerCount, PalmStop)
+    */
+    struct GestureEvent {
+        GestureType type = GestureType::FingerCount;
+        double timeMs = 0.0;
+        int fingers = 0;
+    };
+
+    /*
+    One landmark result, copied by value into the ring.
+    valid is false when the pipeline found no hand.
+    */
+    struct LandmarkSample {
+        double timeMs = 0.0;
+        bool valid = false;
+        float presence = 0.f;
+        std::array<cv::Point2f, GESTURE_NUM_LANDMARKS> points;
+    };
+
+    struct GestureEngineStats {
+        size_t samples = 0;
+        size_t droppedSamples = 0;
+        size_t events = 0;
+        size_t droppedEvents = 0;
+    };
+
+    /*
+    Gesture recognition from landmark trajectories.
+    The inference thread submit()s each landmark result into a lock-free SPSC
+    ring, a consumer thread evaluates it (O(21) per sample, on a fixed-size
+    trajectory window) and pushes events into a second ring, read with
+    pollEvent(). Nothing allocates or locks once started.
+
+    Events: swipes from the palm center trajectory, pinch start / end from
+    the thumb-index tips distance (with hysteresis), palm stop for an open
+    hand held still, and finger count changes. Distances are relative to the
+    hand size, every state is debounced over GESTURE_DEBOUNCE_FRAMES samples.
+    This class is non-copyable.
+    */
+    class GestureEngine {
+        public:
+            GestureEngine();
+            GestureEngine(const GestureEngine& other) = delete;
+            GestureEngine& operator=(const GestureEngine& other) = delete;
+            ~GestureEngine();
+
+            /*
+            Start / stop the consumer thread.
+            */
+            void start();
+            void stop();
+
+            /*
+            Producer side (one thread). landmarks is empty when no hand was found,
+            timeMs < 0 uses the current steady clock time.
+            Return false if the sample was dropped (consumer too late).
+            */
+            bool submit(const std::vector<cv::Point>& landmarks, float presence = 1.f, double timeMs = -1.0);
+
+            /*
+            Consumer of the events (one thread). Return false if there is none.
+            */
+            bool pollEvent(GestureEvent& event);
+
+            GestureEngineStats getStats() const;
+
+            static double now();
+            static const char* toString(GestureType type);
+
+        private:
+            void run();
+
+            /*
+            Evaluate one sample on the consumer thread
+            */
+            void process(const LandmarkSample& sample);
+            void emit(GestureType type, double timeMs, int fingers = 0);
+            void resetTrack();
+
+            static int countFingers(const LandmarkSample& sample);
+
+            /*
+            Detectors read the track of the current sample, a swipe clears it
+            only once all of them have run (true if a swipe was emitted)
+            */
+            bool detectSwipe(const LandmarkSample& sample);
+            void detectPinch(const LandmarkSample& sample);
+            void detectFingersAndStop(const LandmarkSample& sample);
+
+        private:
+            SpscRing<LandmarkSample, GESTURE_QUEUE_SIZE> m_samples;
+            SpscRing<GestureEvent, GESTURE_QUEUE_SIZE> m_events;
+
+            std::thread m_thread;
+            std::atomic<bool> m_running;
+
+            std::atomic<size_t> m_submitted;
+            std::atomic<size_t> m_droppedSamples;
+            std::atomic<size_t> m_emitted;
+            std::atomic<size_t> m_droppedEvents;
+
+            /*
+            Trajectory window, consumer thread only
+            */
+            struct TrackPoint {
+                double timeMs;
+                cv::Point2f palm;
+                float handSize;
+            };
+            std::array<TrackPoint, GESTURE_WINDOW> m_track;
+            size_t m_trackCount;
+            double m_lastSwipeMs;
+
+            bool m_pinched;
+            int m_pinchVotes;
+
+            int m_fingers;          // Last reported count
+            int m_fingerCandidate;
+            int m_fingerVotes;
+            bool m_stopped;
+    };
+}
+
+#endif // GESTUREENGINE_H
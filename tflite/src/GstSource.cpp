@@ -0,0 +1,285 @@
+#include "GstSource.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include <gst/video/video.h>
+
+
+/*
+Helper function
+*/
+static double __nowMs() {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+hand::GstSource::GstSource(const std::string& pipeline, bool mirror, int queueDepth) :
+    m_pipeline(nullptr), m_sink(nullptr), m_mirror(mirror), m_maxQueue(std::max(1, queueDepth)),
+    m_sequence(0), m_eos(false), m_latencySumMs(0.0), m_held(nullptr), m_heldBuffer(nullptr)
+{
+    gst_init(nullptr, nullptr);
+
+    GError* error = nullptr;
+    m_pipeline = gst_parse_launch(pipeline.c_str(), &error);
+    if (error != nullptr) {
+        std::cerr << "GStreamer: cannot parse pipeline: " << error->message << std::endl;
+        g_error_free(error);
+        release();
+        return;
+    }
+
+    m_sink = gst_bin_get_by_name(GST_BIN(m_pipeline), GST_SINK_NAME);
+    if (m_sink == nullptr || GST_IS_APP_SINK(m_sink) == false) {
+        std::cerr << "GStreamer: the pipeline has no appsink named \"" << GST_SINK_NAME << "\"" << std::endl;
+        release();
+        return;
+    }
+
+    /*
+    Formats read by frameToTensor() and toBGR(), the rest is negotiated upstream
+    */
+    GstCaps* caps = gst_caps_from_string("video/x-raw,format={YUY2,NV12,BGR}");
+    gst_app_sink_set_caps(GST_APP_SINK(m_sink), caps);
+    gst_caps_unref(caps);
+
+    GstAppSinkCallbacks callbacks;
+    std::memset(&callbacks, 0, sizeof(callbacks));
+    callbacks.eos = &GstSource::onEos;
+    callbacks.new_sample = &GstSource::onNewSample;
+    gst_app_sink_set_callbacks(GST_APP_SINK(m_sink), &callbacks, this, nullptr);
+
+    if (gst_element_set_state(m_pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        std::cerr << "GStreamer: cannot start pipeline: " << pipeline << std::endl;
+        reportBusError();
+        release();
+        return;
+    }
+}
+
+
+hand::GstSource::~GstSource() {
+    release();
+}
+
+
+bool hand::GstSource::isOpened() const {
+    return m_pipeline != nullptr;
+}
+
+
+bool hand::GstSource::read(Frame& frame) {
+    if (m_pipeline == nullptr)
+        return false;
+
+    releaseHeld();
+
+    PendingSample pending;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        bool ready = m_ready.wait_for(lock, std::chrono::milliseconds(GST_TIMEOUT_MS),
+                                      [this] { return m_queue.empty() == false || m_eos; });
+        if (m_queue.empty()) {
+            lock.unlock();
+            if (ready == false)
+                std::cerr << "GStreamer: no frame within " << GST_TIMEOUT_MS << "ms" << std::endl;
+            reportBusError();
+            return false;
+        }
+
+        pending = m_queue.front();
+        m_queue.pop_front();
+        m_stats.queueDepth = m_queue.size();
+        m_stats.delivered++;
+        m_latencySumMs += pending.pipelineLatencyMs + (__nowMs() - pending.arrivalMs);
+        m_stats.avgLatencyMs = m_latencySumMs / m_stats.delivered;
+    }
+
+    return wrapSample(pending.sample, frame);
+}
+
+
+void hand::GstSource::release() {
+    releaseHeld();
+
+    if (m_pipeline != nullptr)
+        gst_element_set_state(m_pipeline, GST_STATE_NULL);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& pending : m_queue) {
+            gst_sample_unref(pending.sample);
+        }
+        m_queue.clear();
+        m_stats.queueDepth = 0;
+    }
+
+    if (m_sink != nullptr) {
+        gst_object_unref(m_sink);
+        m_sink = nullptr;
+    }
+    if (m_pipeline != nullptr) {
+        gst_object_unref(m_pipeline);
+        m_pipeline = nullptr;
+    }
+}
+
+
+hand::GstSourceStats hand::GstSource::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+//-------------------Private methods start here-------------------
+
+GstFlowReturn hand::GstSource::onNewSample(GstAppSink* sink, gpointer self) {
+    GstSource* source = static_cast<GstSource*>(self);
+    GstSample* sample = gst_app_sink_pull_sample(sink);
+    if (sample == nullptr)
+        return GST_FLOW_OK;
+
+    PendingSample pending = { sample, __nowMs(), source->getPipelineLatencyMs(sample) };
+    {
+        std::lock_guard<std::mutex> lock(source->m_mutex);
+        source->m_stats.received++;
+        while (source->m_queue.size() >= source->m_maxQueue) {
+            gst_sample_unref(source->m_queue.front().sample);
+            source->m_queue.pop_front();
+            source->m_stats.dropped++;
+        }
+        source->m_queue.push_back(pending);
+        source->m_stats.queueDepth = source->m_queue.size();
+        source->m_stats.maxQueueDepth = std::max(source->m_stats.maxQueueDepth, source->m_stats.queueDepth);
+    }
+    source->m_ready.notify_one();
+    return GST_FLOW_OK;
+}
+
+
+void hand::GstSource::onEos(GstAppSink* sink, gpointer self) {
+    GstSource* source = static_cast<GstSource*>(self);
+    {
+        std::lock_guard<std::mutex> lock(source->m_mutex);
+        source->m_eos = true;
+    }
+    source->m_ready.notify_one();
+}
+
+
+bool hand::GstSource::wrapSample(GstSample* sample, Frame& frame) {
+    GstVideoInfo info;
+    GstBuffer* buffer = gst_sample_get_buffer(sample);
+    if (buffer == nullptr || gst_video_info_from_caps(&info, gst_sample_get_caps(sample)) == false) {
+        std::cerr << "GStreamer: sample without video caps" << std::endl;
+        gst_sample_unref(sample);
+        return false;
+    }
+
+    if (gst_buffer_map(buffer, &m_map, GST_MAP_READ) == false) {
+        std::cerr << "GStreamer: cannot map buffer" << std::endl;
+        gst_sample_unref(sample);
+        return false;
+    }
+    m_held = sample;
+    m_heldBuffer = buffer;
+
+    /*
+    The video meta (if any) has the real layout of hardware buffers
+    */
+    int width = GST_VIDEO_INFO_WIDTH(&info);
+    int height = GST_VIDEO_INFO_HEIGHT(&info);
+    size_t stride[2] = { (size_t)GST_VIDEO_INFO_PLANE_STRIDE(&info, 0), (size_t)GST_VIDEO_INFO_PLANE_STRIDE(&info, 1) };
+    size_t offset[2] = { GST_VIDEO_INFO_PLANE_OFFSET(&info, 0), GST_VIDEO_INFO_PLANE_OFFSET(&info, 1) };
+    GstVideoMeta* meta = gst_buffer_get_video_meta(buffer);
+    if (meta != nullptr) {
+        for (int i = 0; i < 2 && i < (int)meta->n_planes; ++i) {
+            stride[i] = meta->stride[i];
+            offset[i] = meta->offset[i];
+        }
+    }
+    uchar* data = m_map.data + offset[0];
+
+    switch (GST_VIDEO_INFO_FORMAT(&info)) {
+        case GST_VIDEO_FORMAT_YUY2:
+            frame.format = PixelFormat::YUYV;
+            frame.data = cv::Mat(height, width, CV_8UC2, data, stride[0]);
+            break;
+        case GST_VIDEO_FORMAT_NV12:
+            frame.format = PixelFormat::NV12;
+            if (stride[0] == stride[1] && offset[1] == offset[0] + stride[0] * height) {
+                frame.data = cv::Mat(height * 3 / 2, width, CV_8UC1, data, stride[0]);
+            }
+            else {
+                m_copy.create(height * 3 / 2, width, CV_8UC1);
+                cv::Mat(height, width, CV_8UC1, data, stride[0]).copyTo(m_copy.rowRange(0, height));
+                cv::Mat(height / 2, width, CV_8UC1, m_map.data + offset[1], stride[1])
+                    .copyTo(m_copy.rowRange(height, height * 3 / 2));
+                frame.data = m_copy;
+            }
+            break;
+        case GST_VIDEO_FORMAT_BGR:
+            frame.format = PixelFormat::BGR;
+            frame.data = cv::Mat(height, width, CV_8UC3, data, stride[0]);
+            break;
+        default:
+            std::cerr << "GStreamer: unsupported format " << GST_VIDEO_INFO_NAME(&info) << std::endl;
+            releaseHeld();
+            return false;
+    }
+
+    frame.mirrored = m_mirror;
+    frame.sequence = m_sequence++;
+    frame.timeMs = __nowMs();
+    return true;
+}
+
+
+void hand::GstSource::releaseHeld() {
+    if (m_held == nullptr)
+        return;
+
+    gst_buffer_unmap(m_heldBuffer, &m_map);
+    gst_sample_unref(m_held);
+    m_held = nullptr;
+    m_heldBuffer = nullptr;
+}
+
+
+void hand::GstSource::reportBusError() const {
+    if (m_pipeline == nullptr)
+        return;
+
+    GstBus* bus = gst_element_get_bus(m_pipeline);
+    GstMessage* message = gst_bus_pop_filtered(bus, GST_MESSAGE_ERROR);
+    if (message != nullptr) {
+        GError* error = nullptr;
+        gst_message_parse_error(message, &error, nullptr);
+        std::cerr << "GStreamer: " << error->message << std::endl;
+        g_error_free(error);
+        gst_message_unref(message);
+    }
+    gst_object_unref(bus);
+}
+
+
+double hand::GstSource::getPipelineLatencyMs(GstSample* sample) const {
+    GstBuffer* buffer = gst_sample_get_buffer(sample);
+    const GstSegment* segment = gst_sample_get_segment(sample);
+    GstClock* clock = gst_element_get_clock(m_pipeline);
+    if (buffer == nullptr || segment == nullptr || clock == nullptr || GST_BUFFER_PTS_IS_VALID(buffer) == false) {
+        if (clock != nullptr)
+            gst_object_unref(clock);
+        return 0.0;
+    }
+
+    GstClockTime runningTime = gst_clock_get_time(clock) - gst_element_get_base_time(m_pipeline);
+    GstClockTime bufferTime = gst_segment_to_running_time(segment, GST_FORMAT_TIME, GST_BUFFER_PTS(buffer));
+    gst_object_unref(clock);
+
+    if (GST_CLOCK_TIME_IS_VALID(bufferTime) == false || runningTime < bufferTime)
+        return 0.0;
+    return (runningTime - bufferTime) / 1e6;
+}
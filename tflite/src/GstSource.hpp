@@ -0,0 +1,132 @@
+#ifndef GSTSOURCE_H
+#define GSTSOURCE_H
+
+#include "FrameSource.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include <gst/gst.h>
+#include <gst/app/gstappsink.h>
+
+/*
+Pi camera through libcamera: the ISP scales to the requested size and
+delivers YUYV, so neither resize nor BGR decode is done on the CPU.
+*/
+#define GST_DEFAULT_PIPELINE \
+    "libcamerasrc ! video/x-raw,width=640,height=480,framerate=30/1,format=YUY2 ! appsink name=sink"
+#define GST_SINK_NAME       "sink"  // The pipeline MUST end in an appsink of this name
+#define GST_QUEUE_DEPTH     2       // Samples waiting for read(), older ones are dropped
+#define GST_TIMEOUT_MS      2000    // read() gives up when no sample comes within this time
+
+namespace hand {
+
+    /*
+    Attributes:
+        received: samples delivered by the appsink
+        delivered: frames returned by read()
+        dropped: samples replaced by a newer one while the queue was full
+        queueDepth: samples waiting right now
+        maxQueueDepth: highest queueDepth seen
+        avgLatencyMs: mean time from the buffer timestamp (pipeline running
+                      time) to read(), queue wait included
+    */
+    struct GstSourceStats {
+        size_t received = 0;
+        size_t delivered = 0;
+        size_t dropped = 0;
+        size_t queueDepth = 0;
+        size_t maxQueueDepth = 0;
+        double avgLatencyMs = 0.0;
+    };
+
+    /*
+    Capture from any GStreamer pipeline ending in "appsink name=sink".
+    videotestsrc or filesrc ! decodebin pipelines can stand in for the camera.
+    The appsink accepts BGR, YUY2 or NV12 (add a caps filter to choose).
+
+    read() maps the GstBuffer and returns a Mat header on its memory, no copy
+    is made (except for NV12 buffers with planes that are not contiguous).
+    The sample stays mapped until the next read(): one sample is held by the
+    application at a time, like V4l2Source.
+    Samples go through a small queue filled by the streaming thread; when the
+    application is slower than the source, the oldest samples are dropped.
+    This class is non-copyable.
+    */
+    class GstSource : public FrameSource {
+        public:
+            /*
+            Parameters:
+                pipeline: gst-launch syntax, see GST_DEFAULT_PIPELINE
+                mirror: deliver frames mirrored (selfie view)
+                queueDepth: samples kept waiting for read()
+            */
+            GstSource(const std::string& pipeline = GST_DEFAULT_PIPELINE, bool mirror = true,
+                      int queueDepth = GST_QUEUE_DEPTH);
+            GstSource(const GstSource& other) = delete;
+            GstSource& operator=(const GstSource& other) = delete;
+            virtual ~GstSource();
+
+            virtual bool isOpened() const;
+            virtual bool read(Frame& frame);
+            virtual void release();
+
+            GstSourceStats getStats() const;
+
+        private:
+            /*
+            appsink callbacks, called from the streaming thread
+            */
+            static GstFlowReturn onNewSample(GstAppSink* sink, gpointer self);
+            static void onEos(GstAppSink* sink, gpointer self);
+
+            /*
+            Wrap the buffer of sample into frame (maps it, sets m_held).
+            Takes ownership of sample, even on failure.
+            */
+            bool wrapSample(GstSample* sample, Frame& frame);
+
+            /*
+            Unmap and give back the sample returned by the last read()
+            */
+            void releaseHeld();
+
+            /*
+            Print the pending error of the pipeline, if any
+            */
+            void reportBusError() const;
+
+            /*
+            Pipeline running time minus the timestamp of sample, 0 if unknown
+            */
+            double getPipelineLatencyMs(GstSample* sample) const;
+
+        private:
+            struct PendingSample {
+                GstSample* sample;
+                double arrivalMs;
+                double pipelineLatencyMs;
+            };
+
+            GstElement* m_pipeline;
+            GstElement* m_sink;
+            bool m_mirror;
+            size_t m_maxQueue;
+            size_t m_sequence;
+
+            mutable std::mutex m_mutex;
+            std::condition_variable m_ready;
+            std::deque<PendingSample> m_queue;
+            bool m_eos;
+            GstSourceStats m_stats;
+            double m_latencySumMs;
+
+            GstSample* m_held;
+            GstBuffer* m_heldBuffer;
+            GstMapInfo m_map;
+            cv::Mat m_copy;     // Only for non-contiguous NV12
+    };
+}
+
+#endif // GSTSOURCE_H
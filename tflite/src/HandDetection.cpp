@@ -1,29 +1,68 @@
 #include "HandDetection.hpp"
+#include "PalmDecodeOp.hpp"
 
 
 hand::HandDetection::HandDetection(std::string modelDir) :
-    hand::ModelLoader(modelDir + std::string("/palm_detection_without_custom_layer.tflite"))  
+    hand::ModelLoader(modelDir + std::string(PALM_DETECTION_MODEL)),
+    m_canBatch(true), m_numTiles(0)
+{}
+
+
+hand::HandDetection::HandDetection(SharedModel palmModel, int numThreads) :
+    hand::ModelLoader(std::move(palmModel), numThreads),
+    m_canBatch(true), m_numTiles(0)
 {}
 
 
 void hand::HandDetection::loadImageToInput(const cv::Mat& in, int index) {
     m_originImage = in;
-    ModelLoader::loadImageToInput(in);
+    m_originFrame = Frame();
+    m_originSize = in.size();
+    m_pyramid.reset(in);
+
+    /*
+    Tiles are loaded by runInference()
+    */
+    if (m_tileOptions.enabled)
+        return;
+
+    std::vector<int> inputShape = getInputShape();
+    int level = m_pyramid.findLevel(cv::Size(inputShape[2], inputShape[1]));
+    ModelLoader::loadImageToInput(m_pyramid.getLevel(level));
+}
+
+
+void hand::HandDetection::loadFrameToInput(const Frame& frame, int index) {
+    m_originImage = cv::Mat();
+    m_originFrame = frame;
+    m_originSize = frame.size();
+    m_pyramid.reset(cv::Mat());
+    if (m_tileOptions.enabled == false)
+        ModelLoader::loadFrameToInput(frame);
 }
 
 
 void hand::HandDetection::runInference() {
-    ModelLoader::runInference();
+    m_detections.clear();
+    if (m_tileOptions.enabled) {
+        runTiledInference();
+    }
+    else {
+        ModelLoader::runInference();
+        m_numTiles = 1;
 
-    auto regressor = getHandRegressor();
-    auto classificator = getHandClassificator();
-    auto detection = m_postProcessor.getHighestScoreDetection(regressor, classificator);
+        auto detections = readDetections(*this, m_postProcessor);
+        if (detections.empty() == false) {
+            m_detections.push_back(*std::max_element(detections.begin(), detections.end(),
+                [](const Detection& a, const Detection& b) { return a.score < b.score; }));
+        }
+    }
 
-    if (detection.classId != -1) {
+    if (m_detections.empty() == false) {
         /*
         The detection is still in local shape [0..1]
         */
-        m_roi = calculateRoiFromDetection(detection);
+        m_roi = calculateRoiFromDetection(m_detections.front());
     }
     else {
         m_roi = cv::Rect();
@@ -51,8 +90,107 @@ cv::Rect hand::HandDetection::getHandRoi() const {
 }
 
 
+std::vector<hand::Detection> hand::HandDetection::getDetections() const {
+    return m_detections;
+}
+
+
+void hand::HandDetection::setTileOptions(const TileOptions& options) {
+    m_tileOptions = options;
+    m_tileOptions.cols = std::max(1, m_tileOptions.cols);
+    m_tileOptions.rows = std::max(1, m_tileOptions.rows);
+    m_tileOptions.overlap = std::min(std::max(m_tileOptions.overlap, 0.f), 0.9f);
+
+    if (m_tileOptions.enabled == false && getBatchSize() != 1)
+        setBatchSize(1);
+}
+
+
+const hand::TileOptions& hand::HandDetection::getTileOptions() const {
+    return m_tileOptions;
+}
+
+
+void hand::HandDetection::setRoiHint(const cv::Rect& hint) {
+    m_roiHint = hint;
+}
+
+
+int hand::HandDetection::getNumberOfTiles() const {
+    return m_numTiles;
+}
+
+
+cv::Rect hand::HandDetection::calculateRoi(const Detection& detection, const cv::Size& imageSize) {
+    int origWidth = imageSize.width;
+    int origHeight = imageSize.height;
+    
+    auto center = (detection.roi.tl() + detection.roi.br()) * 0.5f;
+    center.x *= origWidth;
+    center.y *= origHeight;
+
+    auto w = detection.roi.width * origWidth * 1.5f;
+    auto h = detection.roi.height * origHeight * 2.f;
+
+    return cv::Rect((int)center.x - w/2, (int)center.y - h/2, (int)w, (int)h);
+}
+
+
+std::vector<hand::Detection> hand::HandDetection::readDetections(const ModelLoader& palmModel,
+                                                                 const DetectionPostProcess& postProcessor, int slot) {
+    std::vector<int> shape = palmModel.getOutputShape(0);
+    bool decoded = shape.size() == 3 && shape[2] == PALM_DECODE_NUM_VALUES;
+
+    if (decoded) {
+        const float* rows = palmModel.getOutputData(0) + slot * shape[1] * PALM_DECODE_NUM_VALUES;
+        int count = (int)palmModel.getOutputData(1)[slot];
+        return DetectionPostProcess::readDecodedDetections(rows, count);
+    }
+
+    const float* rawBoxes = palmModel.getOutputData(0) + slot * NUM_BOXES * NUM_COORD;
+    const float* scores = palmModel.getOutputData(1) + slot * NUM_BOXES;
+    return postProcessor.getDetections(rawBoxes, scores);
+}
+
+
 cv::Mat hand::HandDetection::cropFrame(const cv::Rect& roi) const {
-    cv::Mat frame = getOriginalImage();
+    return cropImage(getOriginalImage(), roi);
+}
+
+
+void hand::HandDetection::loadCropToInput(ModelLoader& model, const cv::Rect& roi) {
+    if (m_originFrame.empty() == false) {
+        model.loadFrameRoiToInput(m_originFrame, roi);
+        return;
+    }
+
+    std::vector<int> inputShape = model.getInputShape();
+    int level = m_pyramid.findLevel(cv::Size(inputShape[2], inputShape[1]), roi);
+    model.loadImageToInput(cropImage(m_pyramid.getLevel(level), m_pyramid.toLevel(roi, level)));
+}
+
+//-------------------Protected methods start here-------------------
+
+void hand::HandDetection::setHandRoi(const cv::Mat& image, const cv::Rect& roi) {
+    m_originImage = image;
+    m_originFrame = Frame();
+    m_originSize = image.size();
+    m_pyramid.reset(image);
+    m_roi = roi;
+}
+
+
+void hand::HandDetection::setHandRoi(const Frame& frame, const cv::Rect& roi) {
+    m_originImage = cv::Mat();
+    m_originFrame = frame;
+    m_originSize = frame.size();
+    m_pyramid.reset(cv::Mat());
+    m_roi = roi;
+}
+
+//-------------------Private methods start here-------------------
+
+cv::Mat hand::HandDetection::cropImage(const cv::Mat& frame, const cv::Rect& roi) {
     cv::Size originalSize(roi.size());
 
     cv::Point offsetStart(0, 0);
@@ -84,18 +222,107 @@ cv::Mat hand::HandDetection::cropFrame(const cv::Rect& roi) const {
     return Hand;
 }
 
-//-------------------Private methods start here-------------------
 
-cv::Rect hand::HandDetection::calculateRoiFromDetection(const Detection& detection) const {
-    int origWidth = m_originImage.size().width;
-    int origHeight = m_originImage.size().height;
-    
-    auto center = (detection.roi.tl() + detection.roi.br()) * 0.5f;
-    center.x *= origWidth;
-    center.y *= origHeight;
+void hand::HandDetection::runTiledInference() {
+    std::vector<cv::Rect> tiles = computeTiles();
+    m_numTiles = tiles.size();
+    if (tiles.empty())
+        return;
 
-    auto w = detection.roi.width * origWidth * 1.5f;
-    auto h = detection.roi.height * origHeight * 2.f;
+    /*
+    One invoke for the whole batch when the model allows it.
+    The batch only changes (and tensors are reallocated) with the number of tiles.
+    */
+    int batchSize = m_canBatch ? (int)tiles.size() : 1;
+    if (getBatchSize() != batchSize && setBatchSize(batchSize) == false) {
+        m_canBatch = false;
+        batchSize = 1;
+    }
 
-    return cv::Rect((int)center.x - w/2, (int)center.y - h/2, (int)w, (int)h);
+    std::vector<Detection> candidates;
+    if (batchSize == (int)tiles.size()) {
+        for (int i = 0; i < (int)tiles.size(); ++i) {
+            loadTileToBatch(tiles[i], i);
+        }
+        ModelLoader::runInference();
+        for (int i = 0; i < (int)tiles.size(); ++i) {
+            collectTileDetections(tiles[i], i, candidates);
+        }
+    }
+    else {
+        for (const auto& tile : tiles) {
+            loadTileToBatch(tile, 0);
+            ModelLoader::runInference();
+            collectTileDetections(tile, 0, candidates);
+        }
+    }
+
+    m_detections = nonMaxSuppression(candidates, TILE_NMS_THRESHOLD);
+}
+
+
+std::vector<cv::Rect> hand::HandDetection::computeTiles() const {
+    std::vector<cv::Rect> tiles;
+    const cv::Rect frame(cv::Point(0, 0), m_originSize);
+    if (frame.empty())
+        return tiles;
+
+    if (m_tileOptions.fullFrame)
+        tiles.push_back(frame);
+
+    /*
+    n tiles of size t overlapping by overlap * t cover n * t - (n - 1) * overlap * t
+    */
+    const int cols = m_tileOptions.cols;
+    const int rows = m_tileOptions.rows;
+    const float overlap = m_tileOptions.overlap;
+    const float tileWidth = frame.width / (cols - (cols - 1) * overlap);
+    const float tileHeight = frame.height / (rows - (rows - 1) * overlap);
+
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            float x = cols > 1 ? col * (frame.width - tileWidth) / (cols - 1) : 0.f;
+            float y = rows > 1 ? row * (frame.height - tileHeight) / (rows - 1) : 0.f;
+            cv::Rect tile = cv::Rect(cvRound(x), cvRound(y), cvRound(tileWidth), cvRound(tileHeight)) & frame;
+
+            if (m_tileOptions.fullFrame && tile == frame)
+                continue;
+            if (m_roiHint.empty() == false && (tile & m_roiHint).empty())
+                continue;
+            tiles.push_back(tile);
+        }
+    }
+    return tiles;
+}
+
+
+void hand::HandDetection::loadTileToBatch(const cv::Rect& tile, int slot) {
+    if (m_originFrame.empty() == false) {
+        ModelLoader::loadFrameRoiToBatch(m_originFrame, tile, slot);
+        return;
+    }
+
+    std::vector<int> inputShape = getInputShape();
+    int level = m_pyramid.findLevel(cv::Size(inputShape[2], inputShape[1]), tile);
+    ModelLoader::loadImageToBatch(cropImage(m_pyramid.getLevel(level), m_pyramid.toLevel(tile, level)), slot);
+}
+
+
+void hand::HandDetection::collectTileDetections(const cv::Rect& tile, int slot, std::vector<Detection>& detections) const {
+    const float width = m_originSize.width;
+    const float height = m_originSize.height;
+
+    for (auto detection : readDetections(*this, m_postProcessor, slot)) {
+        detection.roi = cv::Rect2f(
+            (tile.x + detection.roi.x * tile.width) / width,
+            (tile.y + detection.roi.y * tile.height) / height,
+            detection.roi.width * tile.width / width,
+            detection.roi.height * tile.height / height);
+        detections.push_back(detection);
+    }
+}
+
+
+cv::Rect hand::HandDetection::calculateRoiFromDetection(const Detection& detection) const {
+    return calculateRoi(detection, m_originSize);
 }
\ No newline at end of file
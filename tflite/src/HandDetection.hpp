@@ -3,9 +3,31 @@
 
 #include "ModelLoader.hpp"
 #include "DetectionPostProcess.hpp"
+#include "FramePyramid.hpp"
+
+#define PALM_DETECTION_MODEL "/palm_detection_without_custom_layer.tflite"
+#define TILE_NMS_THRESHOLD   0.3f
 
 namespace hand {
 
+    /*
+    Tiled palm detection, for hands too small to be seen in the whole frame
+    squashed to the model input (below ~1/8 of a 1080p frame).
+    Attributes:
+        enabled: run the palm model on tiles instead of the whole frame
+        cols, rows: grid of tiles covering the frame
+        overlap: fraction of a tile shared with its neighbours, so that a hand
+                 cut by a tile border is whole in another tile
+        fullFrame: also run the whole frame as one more tile (hands bigger than a tile)
+    */
+    struct TileOptions {
+        bool enabled = false;
+        int cols = 3;
+        int rows = 2;
+        float overlap = 0.25f;
+        bool fullFrame = true;
+    };
+
     /*
     A model wrapper to use Mediapipe Hand Detector.
     This class is non-copyable.
@@ -16,6 +38,11 @@ namespace hand {
             Users MUST provide the FOLDER contain Hand_detection_short.tflite, NOT THE FILE itself.
             */
             HandDetection(std::string modelPath);
+
+            /*
+            Build a detector on top of an already loaded palm detection model.
+            */
+            HandDetection(SharedModel palmModel, int numThreads = -1);
             virtual ~HandDetection() = default;
 
             /*
@@ -39,12 +66,60 @@ namespace hand {
             */
             virtual cv::Rect getHandRoi() const;
 
+            /*
+            Every hand found by the last palm inference (best first, after NMS),
+            boxes relative to the image [0..1]. Only the best one without tiles.
+            */
+            std::vector<Detection> getDetections() const;
+
+            /*
+            Enable / configure tiled detection. Tiles of one frame run as a single
+            batched invoke when the model accepts a batch, one by one otherwise;
+            their detections are merged with NMS.
+            */
+            void setTileOptions(const TileOptions& options);
+            const TileOptions& getTileOptions() const;
+
+            /*
+            Only run the tiles which intersect hint (image pixels), e.g. around
+            the last known hand. The full frame tile always runs. Empty: all tiles.
+            */
+            void setRoiHint(const cv::Rect& hint);
+
+            /*
+            Tiles run by the last palm inference
+            */
+            int getNumberOfTiles() const;
+
+            /*
+            Hand roi (image pixels) around a palm detection relative to an image of imageSize.
+            */
+            static cv::Rect calculateRoi(const Detection& detection, const cv::Size& imageSize);
+
+            /*
+            Detections of slot of the last batch run by palmModel, relative to its input [0..1].
+            Raw outputs are decoded with postProcessor; models ending with the in-graph
+            decode op (see PalmDecodeOp.hpp) already give the final hands, best first.
+            */
+            static std::vector<Detection> readDetections(const ModelLoader& palmModel,
+                                                         const DetectionPostProcess& postProcessor, int slot = 0);
+
             /*
             Override function from ModelLoader.
+            The model input is resized from the coarsest pyramid level still
+            larger than the input, not from the full frame.
             (Note: index does not matter, the model always load to InputTensor(0))
             */
             virtual void loadImageToInput(const cv::Mat& inputImage, int index = 0);       
 
+            /*
+            Override function from ModelLoader.
+            The frame is kept (not copied) for the crops of the landmark model,
+            so it must stay valid until the inference is done.
+            (Note: index does not matter, the model always load to InputTensor(0))
+            */
+            virtual void loadFrameToInput(const Frame& frame, int index = 0);
+
             /*
             Override function from ModelLoader.
             Can only run when all input tensors have been loaded.
@@ -56,6 +131,22 @@ namespace hand {
             */
             cv::Mat cropFrame(const cv::Rect& roi) const;
 
+            /*
+            Load roi of the input (image or frame) to model, resized to its input.
+            An image is cropped from the pyramid level best matching the roi scale,
+            a Frame input is converted directly, without the cropFrame() copy.
+            */
+            void loadCropToInput(ModelLoader& model, const cv::Rect& roi);
+
+
+        protected:
+            /*
+            Use roi as the hand position in image without running the palm model
+            (e.g. when the hand is tracked from the previous landmarks).
+            */
+            void setHandRoi(const cv::Mat& image, const cv::Rect& roi);
+            void setHandRoi(const Frame& frame, const cv::Rect& roi);
+
 
         private:
             /*
@@ -64,6 +155,31 @@ namespace hand {
             */
             using ModelLoader::loadBytesToInput;
 
+            /*
+            Crop image at roi (padding with black if need)
+            */
+            static cv::Mat cropImage(const cv::Mat& image, const cv::Rect& roi);
+
+            /*
+            Palm detection on the tiles of the input, merged into m_detections
+            */
+            void runTiledInference();
+
+            /*
+            Tiles to run for the current input and hint (image pixels)
+            */
+            std::vector<cv::Rect> computeTiles() const;
+
+            /*
+            Load tile of the input (image or frame) into slot of the batch
+            */
+            void loadTileToBatch(const cv::Rect& tile, int slot);
+
+            /*
+            Decode the detections of slot, mapped from tile to the image [0..1]
+            */
+            void collectTileDetections(const cv::Rect& tile, int slot, std::vector<Detection>& detections) const;
+
             /*       
             Convert Detection box back to original size
             */
@@ -80,7 +196,16 @@ namespace hand {
             Save some informations
             */
             cv::Mat m_originImage;
+            Frame m_originFrame;    // Set instead of m_originImage by loadFrameToInput()
+            FramePyramid m_pyramid; // Levels of m_originImage, built on demand
+            cv::Size m_originSize;
             cv::Rect m_roi;
+            std::vector<Detection> m_detections;
+
+            TileOptions m_tileOptions;
+            cv::Rect m_roiHint;
+            bool m_canBatch;    // False once the model refused a batch
+            int m_numTiles;
     };
 }
 #endif // HandDETECTION_H
\ No newline at end of file
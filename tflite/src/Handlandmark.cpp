@@ -15,9 +15,23 @@ bool __isIndexValid(int idx) {
 }
 
 
+hand::HandModels hand::HandModels::load(const std::string& modelDir) {
+    HandModels models;
+    models.palm = ModelLoader::loadModel(modelDir + std::string(PALM_DETECTION_MODEL));
+    models.landmark = ModelLoader::loadModel(modelDir + std::string(HAND_LANDMARK_MODEL));
+    return models;
+}
+
+
 hand::HandLandmark::HandLandmark(std::string modelPath) :
     HandDetection(modelPath),
-    m_landmarkModel(modelPath + std::string("/hand_landmark_full.tflite")) // Just change the model path
+    m_landmarkModel(modelPath + std::string(HAND_LANDMARK_MODEL)) // Just change the model path
+{}
+
+
+hand::HandLandmark::HandLandmark(const HandModels& models, int numThreads) :
+    HandDetection(models.palm, numThreads),
+    m_landmarkModel(models.landmark, numThreads)
 {}
 
 
@@ -26,12 +40,61 @@ void hand::HandLandmark::runInference() {
     auto roi = HandDetection::getHandRoi();
     if (roi.empty()) return;
 
-    auto Hand = HandDetection::cropFrame(roi);
-    m_landmarkModel.loadImageToInput(Hand);
+    HandDetection::loadCropToInput(m_landmarkModel, roi);
     m_landmarkModel.runInference();
 }
 
 
+void hand::HandLandmark::runTracking(const cv::Mat& image, const cv::Rect& roi) {
+    HandDetection::setHandRoi(image, roi);
+    if (roi.empty()) return;
+
+    HandDetection::loadCropToInput(m_landmarkModel, roi);
+    m_landmarkModel.runInference();
+
+    if (getHandPresence() < HAND_PRESENCE_THRESHOLD)
+        HandDetection::setHandRoi(image, cv::Rect());
+}
+
+
+void hand::HandLandmark::runTracking(const Frame& frame, const cv::Rect& roi) {
+    HandDetection::setHandRoi(frame, roi);
+    if (roi.empty()) return;
+
+    HandDetection::loadCropToInput(m_landmarkModel, roi);
+    m_landmarkModel.runInference();
+
+    if (getHandPresence() < HAND_PRESENCE_THRESHOLD)
+        HandDetection::setHandRoi(frame, cv::Rect());
+}
+
+
+float hand::HandLandmark::getHandPresence() const {
+    if (HandDetection::getHandRoi().empty())
+        return 0.f;
+
+    /*
+    The second output of the landmark model is the hand flag.
+    */
+    if (m_landmarkModel.getNumberOfOutputs() < 2)
+        return 1.f;
+    return m_landmarkModel.getOutputData(1)[0];
+}
+
+
+cv::Rect hand::HandLandmark::getRoiFromLandmarks() const {
+    auto landmarks = getAllHandLandmarks();
+    if (landmarks.empty())
+        return cv::Rect();
+
+    auto box = cv::boundingRect(landmarks);
+    auto center = (box.tl() + box.br()) / 2;
+    int side = (int)(std::max(box.width, box.height) * TRACK_ROI_SCALE);
+
+    return cv::Rect(center.x - side / 2, center.y - side / 2, side, side);
+}
+
+
 cv::Point hand::HandLandmark::getHandLandmarkAt(int index) const {
     if (__isIndexValid(index)) {
         auto roi = HandDetection::getHandRoi();
@@ -67,3 +130,34 @@ std::vector<float> hand::HandLandmark::loadOutput(int index) const {
     return m_landmarkModel.loadOutput();
 }
 
+
+void hand::HandLandmark::setSharedArena(bool shared) {
+    HandDetection::setSharedArena(shared);
+    m_landmarkModel.setSharedArena(shared);
+}
+
+
+hand::ModelMemory hand::HandLandmark::getMemoryInfo() const {
+    ModelMemory palm = getPalmMemoryInfo();
+    ModelMemory landmark = getLandmarkMemoryInfo();
+
+    ModelMemory combined;
+    combined.arenaBytes = isSharedArena() ? std::max(palm.arenaBytes, landmark.arenaBytes)
+                                          : palm.arenaBytes + landmark.arenaBytes;
+    combined.persistentBytes = palm.persistentBytes + landmark.persistentBytes;
+    combined.weightBytes = palm.weightBytes + landmark.weightBytes;
+    combined.reservedBytes = isSharedArena() ? combined.arenaBytes + combined.persistentBytes
+                                             : palm.reservedBytes + landmark.reservedBytes;
+    return combined;
+}
+
+
+hand::ModelMemory hand::HandLandmark::getPalmMemoryInfo() const {
+    return HandDetection::getMemoryInfo();
+}
+
+
+hand::ModelMemory hand::HandLandmark::getLandmarkMemoryInfo() const {
+    return m_landmarkModel.getMemoryInfo();
+}
+
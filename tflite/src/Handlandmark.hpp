@@ -6,8 +6,27 @@
 #include <bitset>
 #include <vector>
 
+#define HAND_LANDMARK_MODEL "/hand_landmark_full.tflite"
+#define HAND_PRESENCE_THRESHOLD 0.5f
+#define TRACK_ROI_SCALE 1.5f
+
 namespace hand {
 
+    /*
+    The models needed by HandLandmark, loaded once.
+    Every HandLandmark built from the same HandModels shares these buffers
+    and only owns its interpreter (tensors and scratch memory).
+    */
+    struct HandModels {
+        SharedModel palm;
+        SharedModel landmark;
+
+        /*
+        Users MUST provide the FOLDER contain the models, NOT THE FILE itself.
+        */
+        static HandModels load(const std::string& modelDir);
+    };
+
     class HandLandmark : public hand::HandDetection {
         public:
             /*
@@ -15,6 +34,11 @@ namespace hand {
             face_landmark.tflite and iris_landmark.tflite 
             */
             HandLandmark(std::string modelPath);
+
+            /*
+            Build a new inference session from shared models.
+            */
+            HandLandmark(const HandModels& models, int numThreads = -1);
             virtual ~HandLandmark() = default; 
 
             /*
@@ -22,6 +46,25 @@ namespace hand {
             */
             virtual void runInference();
 
+            /*
+            Run only the landmark model on roi of image, skipping palm detection.
+            Used to follow a hand found in a previous frame (see getRoiFromLandmarks()).
+            If the model does not see a hand anymore, getHandRoi() becomes empty.
+            */
+            virtual void runTracking(const cv::Mat& image, const cv::Rect& roi);
+            virtual void runTracking(const Frame& frame, const cv::Rect& roi);
+
+            /*
+            Get the hand presence score of the last landmark inference (0 if it has not run).
+            */
+            float getHandPresence() const;
+
+            /*
+            Get a square roi around the current landmarks, suitable for runTracking() 
+            on the next frame. Empty if there is no hand.
+            */
+            cv::Rect getRoiFromLandmarks() const;
+
             /*
             Get a landmark from output (index must be in range 0-467)
             The position is relative to the input image at InputTensor(0)
@@ -43,6 +86,26 @@ namespace hand {
             */
             virtual std::vector<float> loadOutput(int index = 0) const;
 
+            /*
+            Override function from ModelLoader.
+            Palm detection and landmarks run one after the other, so with a shared
+            arena only the larger of the two arenas is held at a time.
+            */
+            virtual void setSharedArena(bool shared);
+
+            /*
+            Override function from ModelLoader.
+            Combined memory of both interpreters: arenas add up, or the larger one
+            counts alone with a shared arena.
+            */
+            virtual ModelMemory getMemoryInfo() const;
+
+            /*
+            Memory of each interpreter
+            */
+            ModelMemory getPalmMemoryInfo() const;
+            ModelMemory getLandmarkMemoryInfo() const;
+
         private:
             hand::ModelLoader m_landmarkModel;
 
@@ -0,0 +1,138 @@
+#include "InferencePool.hpp"
+
+#include <algorithm>
+
+
+hand::InferencePool::InferencePool(const HandModels& models, int numSessions, int threadsPerSession) :
+    m_nextWorker(0), m_pending(0), m_stolen(0), m_running(0), m_stop(false)
+{
+    numSessions = std::max(numSessions, 1);
+
+    /*
+    Build every session before starting any thread so that
+    steal() never sees a partially constructed worker list.
+    */
+    for (int i = 0; i < numSessions; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->session = std::make_unique<HandLandmark>(models, threadsPerSession);
+        m_workers.push_back(std::move(worker));
+    }
+
+    for (int i = 0; i < numSessions; ++i) {
+        m_workers[i]->thread = std::thread(&InferencePool::workerLoop, this, i);
+    }
+}
+
+
+hand::InferencePool::~InferencePool() {
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_stop = true;
+    }
+    m_waitCondition.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
+}
+
+
+void hand::InferencePool::submit(Task task) {
+    size_t index = m_nextWorker++ % m_workers.size();
+
+    /*
+    Counted before the task is visible, so a worker popping it
+    can never take m_pending below zero.
+    */
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        ++m_pending;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+        m_workers[index]->tasks.push_back(std::move(task));
+    }
+    m_waitCondition.notify_one();
+}
+
+
+void hand::InferencePool::waitIdle() {
+    std::unique_lock<std::mutex> lock(m_waitMutex);
+    m_idleCondition.wait(lock, [this] { return m_pending == 0 && m_running == 0; });
+}
+
+
+int hand::InferencePool::getNumberOfSessions() const {
+    return m_workers.size();
+}
+
+
+size_t hand::InferencePool::getStolenCount() const {
+    return m_stolen;
+}
+
+//-------------------Private methods start here-------------------
+
+void hand::InferencePool::workerLoop(int index) {
+    HandLandmark& session = *m_workers[index]->session;
+
+    while (true) {
+        Task task;
+        if (popLocal(index, task) || steal(index, task)) {
+            {
+                std::lock_guard<std::mutex> lock(m_waitMutex);
+                --m_pending;
+                ++m_running;
+            }
+            task(session);
+
+            bool idle;
+            {
+                std::lock_guard<std::mutex> lock(m_waitMutex);
+                idle = (--m_running == 0 && m_pending == 0);
+            }
+            if (idle)
+                m_idleCondition.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_waitCondition.wait(lock, [this] { return m_stop || m_pending > 0; });
+
+        /*
+        Queued tasks are drained before the pool shuts down.
+        */
+        if (m_stop && m_pending == 0)
+            return;
+    }
+}
+
+
+bool hand::InferencePool::popLocal(int index, Task& task) {
+    Worker& worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty())
+        return false;
+
+    task = std::move(worker.tasks.front());
+    worker.tasks.pop_front();
+    return true;
+}
+
+
+bool hand::InferencePool::steal(int thief, Task& task) {
+    int n = m_workers.size();
+    for (int offset = 1; offset < n; ++offset) {
+        Worker& victim = *m_workers[(thief + offset) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty())
+            continue;
+
+        task = std::move(victim.tasks.back());
+        victim.tasks.pop_back();
+        ++m_stolen;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,116 @@
+#ifndef INFERENCEPOOL_H
+#define INFERENCEPOOL_H
+
+#include "Handlandmark.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hand {
+
+    /*
+    A pool of HandLandmark sessions, one worker thread per session.
+    All sessions share the same HandModels, so adding a session only costs
+    one more interpreter (tensor arena), never another copy of the models.
+
+    Each worker owns a task deque. Tasks are pushed round-robin, a worker pops
+    from the front of its own deque and, when it runs dry, steals from the back
+    of the other deques. A slow stream therefore never blocks an idle session.
+    This class is non-copyable.
+    */
+    class InferencePool {
+        public:
+            using Task = std::function<void(HandLandmark&)>;
+
+            /*
+            Parameters:
+                models: models shared by every session
+                numSessions: number of sessions (and worker threads), at least 1
+                threadsPerSession: threads given to each tflite interpreter
+            */
+            InferencePool(const HandModels& models, int numSessions, int threadsPerSession = 1);
+            InferencePool(const InferencePool& other) = delete;
+            InferencePool& operator=(const InferencePool& other) = delete;
+            ~InferencePool();
+
+            /*
+            Queue a task. It runs on whichever session picks it up first.
+            */
+            void submit(Task task);
+
+            /*
+            Block until no task is queued or running
+            (tasks submitted by running tasks included).
+            */
+            void waitIdle();
+
+            /*
+            Get number of sessions in the pool.
+            */
+            int getNumberOfSessions() const;
+
+            /*
+            Get number of tasks which were stolen from another worker's deque.
+            */
+            size_t getStolenCount() const;
+
+        private:
+            struct Worker {
+                std::unique_ptr<HandLandmark> session;
+                std::deque<Task> tasks;
+                std::mutex mutex;
+                std::thread thread;
+            };
+
+            void workerLoop(int index);
+
+            /*
+            Take the oldest task of worker[index].
+            */
+            bool popLocal(int index, Task& task);
+
+            /*
+            Take the newest task of any other worker.
+            */
+            bool steal(int thief, Task& task);
+
+        private:
+            std::vector<std::unique_ptr<Worker>> m_workers;
+
+            /*
+            Round-robin cursor for submit()
+            */
+            std::atomic<size_t> m_nextWorker;
+
+            /*
+            Number of queued tasks over all workers (changed under m_waitMutex)
+            */
+            std::atomic<size_t> m_pending;
+            std::atomic<size_t> m_stolen;
+
+            /*
+            Number of tasks being run (under m_waitMutex)
+            */
+            size_t m_running;
+
+            /*
+            Idle workers sleep here until a task is submitted
+            */
+            std::mutex m_waitMutex;
+            std::condition_variable m_waitCondition;
+
+            /*
+            waitIdle() sleeps here until the last task ends
+            */
+            std::condition_variable m_idleCondition;
+            bool m_stop;
+    };
+}
+
+#endif // INFERENCEPOOL_H
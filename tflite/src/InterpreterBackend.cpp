@@ -0,0 +1,203 @@
+#include "InterpreterBackend.hpp"
+#include "PalmDecodeOp.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include "tensorflow/lite/kernels/register.h"
+
+#if SELECTED_OPS
+#include "SelectedOps.hpp"  // Generated from the loaded models by "model_surgery ops" (see CMakeLists.txt)
+#include "tensorflow/lite/tflite_with_xnnpack_optional.h"
+#endif
+
+
+#if SELECTED_OPS
+/*
+Only the builtin ops of the loaded models: with a static TFLite the linker
+drops every other kernel, and building the resolver registers a handful of
+ops instead of all of them. XNNPACK is kept, as BuiltinOpResolver would apply it.
+*/
+class SelectedOpResolver : public tflite::MutableOpResolver {
+    public:
+        SelectedOpResolver() {
+            hand::registerSelectedOps(*this);
+        }
+
+        virtual TfLiteDelegatePtrVector GetDelegates(int numThreads) const {
+            TfLiteDelegatePtrVector delegates;
+            auto xnnpack = tflite::MaybeCreateXNNPACKDelegate(numThreads);
+            if (xnnpack != nullptr)
+                delegates.push_back(std::move(xnnpack));
+            return delegates;
+        }
+};
+#endif
+
+
+#if SELECTED_OPS
+using OpResolver = SelectedOpResolver;
+#else
+using OpResolver = tflite::ops::builtin::BuiltinOpResolver;
+#endif
+
+
+/*
+Helper function: the op resolver, built once and shared by every interpreter
+(InterpreterBuilder only reads it)
+*/
+static const OpResolver& __getOpResolver() {
+    static const OpResolver resolver = [] {
+        OpResolver ops;
+        ops.AddCustom(PALM_DECODE_OP_NAME, hand::registerPalmDecodeOp());
+        return ops;
+    }();
+    return resolver;
+}
+
+
+std::unique_ptr<hand::ModelBackend> hand::ModelBackend::create(SharedModel model, int numThreads) {
+    return std::unique_ptr<ModelBackend>(new InterpreterBackend(std::move(model), numThreads));
+}
+
+
+hand::SharedModel hand::ModelBackend::loadModel(const std::string& modelPath) {
+    SharedModel model = tflite::FlatBufferModel::BuildFromFile(modelPath.c_str());
+    if (model == nullptr) {
+        std::cerr << "Fail to build FlatBufferModel from file: " << modelPath << std::endl;
+        std::exit(1);
+    }
+    return model;
+}
+
+
+hand::InterpreterBackend::InterpreterBackend(SharedModel model, int numThreads) :
+    m_model(std::move(model))
+{
+    if (tflite::InterpreterBuilder(*m_model, __getOpResolver())(&m_interpreter) != kTfLiteOk) {
+        std::cerr << "Failed to build interpreter." << std::endl;
+        std::exit(1);
+    }
+    m_interpreter->SetNumThreads(numThreads);
+    allocateTensors();
+    measureMemory();
+}
+
+
+std::vector<hand::TensorWrapper> hand::InterpreterBackend::getInputs() {
+    return wrapTensors(m_interpreter->inputs());
+}
+
+
+std::vector<hand::TensorWrapper> hand::InterpreterBackend::getOutputs() {
+    return wrapTensors(m_interpreter->outputs());
+}
+
+
+bool hand::InterpreterBackend::resizeInput(int index, const std::vector<int>& shape) {
+    int input = m_interpreter->inputs()[index];
+    TfLiteIntArray* dims = m_interpreter->tensor(input)->dims;
+    std::vector<int> previous(dims->data, dims->data + dims->size);
+
+    bool resized = m_interpreter->ResizeInputTensor(input, shape) == kTfLiteOk
+                && m_interpreter->AllocateTensors() == kTfLiteOk;
+
+    /*
+    Every output must follow the batch, or the model only pretends to run it
+    */
+    for (int i = 0; resized && i < (int)m_interpreter->outputs().size(); ++i) {
+        TfLiteTensor* output = m_interpreter->tensor(m_interpreter->outputs()[i]);
+        resized = output->dims->size > 0 && output->dims->data[0] == shape[0];
+    }
+
+    if (resized == false) {
+        m_interpreter->ResizeInputTensor(input, previous);
+        allocateTensors();
+    }
+    measureMemory();
+    return resized;
+}
+
+
+bool hand::InterpreterBackend::invoke() {
+    return m_interpreter->Invoke() == kTfLiteOk; // Tflite inference
+}
+
+
+bool hand::InterpreterBackend::canReleaseArena() const {
+    return true;
+}
+
+
+void hand::InterpreterBackend::releaseArena() {
+    if (m_interpreter->ReleaseNonPersistentMemory() != kTfLiteOk)
+        std::cerr << "Failed to release the tensor arena." << std::endl;
+}
+
+
+void hand::InterpreterBackend::acquireArena() {
+    allocateTensors();
+}
+
+
+hand::ModelMemory hand::InterpreterBackend::getMemoryInfo() const {
+    return m_memory;
+}
+
+//-------------------Private methods start here-------------------
+
+void hand::InterpreterBackend::allocateTensors() {
+    if (m_interpreter->AllocateTensors() != kTfLiteOk) {
+        std::cerr << "Failed to allocate tensors." << std::endl;
+        std::exit(1);
+    }
+}
+
+
+std::vector<hand::TensorWrapper> hand::InterpreterBackend::wrapTensors(const std::vector<int>& indices) {
+    std::vector<TensorWrapper> tensors;
+    for (auto index: indices) {
+        TfLiteTensor* tensor = m_interpreter->tensor(index);
+        TfLiteIntArray* dims = tensor->dims;
+
+        tensors.push_back({
+            tensor->data.f,
+            tensor->bytes,
+            dims->data,
+            dims->size,
+            tensor->type
+        });
+    }
+    return tensors;
+}
+
+
+void hand::InterpreterBackend::measureMemory() {
+    /*
+    Each allocation type is one contiguous buffer: its span is the planned size
+    */
+    const char* begin[2] = {nullptr, nullptr};
+    const char* end[2] = {nullptr, nullptr};
+    m_memory = ModelMemory();
+
+    for (int i = 0; i < (int)m_interpreter->tensors_size(); ++i) {
+        const TfLiteTensor* tensor = m_interpreter->tensor(i);
+        const char* data = tensor->data.raw;
+        if (data == nullptr || tensor->bytes == 0)
+            continue;
+
+        if (tensor->allocation_type == kTfLiteMmapRo) {
+            m_memory.weightBytes += tensor->bytes;
+            continue;
+        }
+        int k = tensor->allocation_type == kTfLiteArenaRw ? 0
+              : tensor->allocation_type == kTfLiteArenaRwPersistent ? 1 : -1;
+        if (k == -1)
+            continue;
+        begin[k] = begin[k] == nullptr ? data : std::min(begin[k], data);
+        end[k] = std::max(end[k], data + tensor->bytes);
+    }
+    m_memory.arenaBytes = end[0] - begin[0];
+    m_memory.persistentBytes = end[1] - begin[1];
+    m_memory.reservedBytes = m_memory.arenaBytes + m_memory.persistentBytes;
+}
@@ -0,0 +1,66 @@
+#ifndef INTERPRETERBACKEND_H
+#define INTERPRETERBACKEND_H
+
+#include "ModelBackend.hpp"
+
+#include "tensorflow/lite/interpreter.h"
+#include "tensorflow/lite/model.h"
+
+namespace hand {
+
+    /*
+    ModelBackend running tflite::Interpreter: arena planned by AllocateTensors,
+    resizable inputs, default delegates (XNNPACK) of the op resolver.
+    This class is non-copyable.
+    */
+    class InterpreterBackend : public ModelBackend {
+        public:
+            /*
+            Parameters:
+                model: model returned by ModelLoader::loadModel()
+                numThreads: number of threads used by the interpreter (-1: let tflite decide)
+            */
+            InterpreterBackend(SharedModel model, int numThreads = -1);
+            InterpreterBackend(const InterpreterBackend& other) = delete;
+            InterpreterBackend& operator=(const InterpreterBackend& other) = delete;
+            virtual ~InterpreterBackend() = default;
+
+            virtual std::vector<TensorWrapper> getInputs();
+            virtual std::vector<TensorWrapper> getOutputs();
+
+            /*
+            Every output must follow the batch of the input, or the resize is refused.
+            */
+            virtual bool resizeInput(int index, const std::vector<int>& shape);
+
+            virtual bool invoke();
+
+            /*
+            ReleaseNonPersistentMemory() / AllocateTensors() (same plan, no replanning)
+            */
+            virtual bool canReleaseArena() const;
+            virtual void releaseArena();
+            virtual void acquireArena();
+
+            virtual ModelMemory getMemoryInfo() const;
+
+        private:
+            void allocateTensors();
+            std::vector<TensorWrapper> wrapTensors(const std::vector<int>& indices);
+
+            /*
+            Measure m_memory from the tensors of the interpreter
+            */
+            void measureMemory();
+
+        private:
+            /*
+            TFLite core (may be shared with other ModelLoader)
+            */
+            SharedModel m_model;
+            std::unique_ptr<tflite::Interpreter> m_interpreter;
+            ModelMemory m_memory;
+    };
+}
+
+#endif // INTERPRETERBACKEND_H
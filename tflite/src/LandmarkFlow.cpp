@@ -0,0 +1,100 @@
+#include "LandmarkFlow.hpp"
+
+#include <algorithm>
+
+
+hand::LandmarkFlow::LandmarkFlow(int windowSize, int pyramidLevels) :
+    m_windowSize(windowSize, windowSize), m_pyramidLevels(pyramidLevels)
+{}
+
+
+void hand::LandmarkFlow::reset(const cv::Mat& frame, const std::vector<cv::Point>& landmarks) {
+    m_stats.resets++;
+    m_prevPoints.assign(landmarks.begin(), landmarks.end());
+    if (m_prevPoints.empty())
+        return;
+
+    toGray(frame, m_prevGray);
+}
+
+
+bool hand::LandmarkFlow::propagate(const cv::Mat& frame, std::vector<cv::Point>& landmarks) {
+    if (m_prevPoints.empty())
+        return false;
+
+    toGray(frame, m_gray);
+
+    cv::TermCriteria criteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 20, 0.03);
+    cv::calcOpticalFlowPyrLK(m_prevGray, m_gray, m_prevPoints, m_nextPoints,
+        m_status, m_error, m_windowSize, m_pyramidLevels, criteria);
+    cv::calcOpticalFlowPyrLK(m_gray, m_prevGray, m_nextPoints, m_backPoints,
+        m_backStatus, m_error, m_windowSize, m_pyramidLevels, criteria);
+
+    /*
+    Forward-backward consistency check
+    */
+    int n = m_prevPoints.size();
+    std::vector<bool> consistent(n, false);
+    std::vector<float> dx, dy;
+    for (int i = 0; i < n; ++i) {
+        if (m_status[i] == 0 || m_backStatus[i] == 0)
+            continue;
+
+        auto roundTrip = m_backPoints[i] - m_prevPoints[i];
+        if (roundTrip.dot(roundTrip) > FLOW_MAX_FB_ERROR * FLOW_MAX_FB_ERROR)
+            continue;
+
+        consistent[i] = true;
+        dx.push_back(m_nextPoints[i].x - m_prevPoints[i].x);
+        dy.push_back(m_nextPoints[i].y - m_prevPoints[i].y);
+    }
+
+    if (dx.size() < n * FLOW_MIN_CONSISTENT) {
+        m_stats.resyncs++;
+        m_prevPoints.clear();
+        return false;
+    }
+
+    /*
+    Inconsistent landmarks follow the median motion of the hand
+    */
+    std::nth_element(dx.begin(), dx.begin() + dx.size() / 2, dx.end());
+    std::nth_element(dy.begin(), dy.begin() + dy.size() / 2, dy.end());
+    cv::Point2f median(dx[dx.size() / 2], dy[dy.size() / 2]);
+
+    for (int i = 0; i < n; ++i) {
+        if (consistent[i] == false)
+            m_nextPoints[i] = m_prevPoints[i] + median;
+    }
+
+    landmarks.resize(n);
+    for (int i = 0; i < n; ++i) {
+        landmarks[i] = cv::Point(cvRound(m_nextPoints[i].x), cvRound(m_nextPoints[i].y));
+    }
+
+    std::swap(m_prevPoints, m_nextPoints);
+    cv::swap(m_prevGray, m_gray);
+    m_stats.propagated++;
+    return true;
+}
+
+
+bool hand::LandmarkFlow::isTracking() const {
+    return m_prevPoints.empty() == false;
+}
+
+
+hand::LandmarkFlowStats hand::LandmarkFlow::getStats() const {
+    return m_stats;
+}
+
+//-------------------Private methods start here-------------------
+
+void hand::LandmarkFlow::toGray(const cv::Mat& frame, cv::Mat& gray) const {
+    if (frame.channels() == 4)
+        cv::cvtColor(frame, gray, cv::COLOR_BGRA2GRAY);
+    else if (frame.channels() == 3)
+        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    else
+        frame.copyTo(gray);
+}
@@ -0,0 +1,88 @@
+#ifndef LANDMARKFLOW_H
+#define LANDMARKFLOW_H
+
+#include <vector>
+
+#include "opencv2/core.hpp"
+#include "opencv2/imgproc.hpp"
+#include "opencv2/video.hpp"
+
+#define FLOW_WINDOW_SIZE      21     // Lucas-Kanade search window (pixels)
+#define FLOW_PYRAMID_LEVELS   3
+#define FLOW_MAX_FB_ERROR     2.f    // Max forward-backward error of a consistent point (pixels)
+#define FLOW_MIN_CONSISTENT   0.7f   // Min fraction of consistent landmarks, below it resync
+
+namespace hand {
+
+    /*
+    Counters of a LandmarkFlow.
+    Attributes:
+        resets: neural results given to reset()
+        propagated: frames whose landmarks came from optical flow
+        resyncs: propagations refused by the consistency check
+    */
+    struct LandmarkFlowStats {
+        size_t resets = 0;
+        size_t propagated = 0;
+        size_t resyncs = 0;
+    };
+
+    /*
+    Carry hand landmarks from one frame to the next with pyramidal Lucas-Kanade flow,
+    so landmarks can be output at camera rate while the network runs less often.
+
+    Each landmark is tracked forward (previous -> current) then backward
+    (current -> previous). Landmarks whose round trip ends far from where they
+    started are inconsistent; they are moved by the median motion of the good ones.
+    When too few landmarks are consistent, propagate() fails and the neural
+    pipeline MUST run on the frame (resync).
+    */
+    class LandmarkFlow {
+        public:
+            LandmarkFlow(int windowSize = FLOW_WINDOW_SIZE, int pyramidLevels = FLOW_PYRAMID_LEVELS);
+
+            /*
+            Restart from a neural result on frame (BGR).
+            An empty landmarks vector means there is no hand to propagate.
+            */
+            void reset(const cv::Mat& frame, const std::vector<cv::Point>& landmarks);
+
+            /*
+            Move the landmarks onto frame (BGR).
+            Return false (and leave landmarks untouched) if there is nothing to track
+            or the flow is not consistent enough.
+            */
+            bool propagate(const cv::Mat& frame, std::vector<cv::Point>& landmarks);
+
+            /*
+            True if reset() was given landmarks and no resync happened since.
+            */
+            bool isTracking() const;
+
+            LandmarkFlowStats getStats() const;
+
+        private:
+            void toGray(const cv::Mat& frame, cv::Mat& gray) const;
+
+        private:
+            cv::Size m_windowSize;
+            int m_pyramidLevels;
+
+            cv::Mat m_prevGray;
+            std::vector<cv::Point2f> m_prevPoints;
+
+            /*
+            Buffers reused between frames
+            */
+            cv::Mat m_gray;
+            std::vector<cv::Point2f> m_nextPoints;
+            std::vector<cv::Point2f> m_backPoints;
+            std::vector<unsigned char> m_status;
+            std::vector<unsigned char> m_backStatus;
+            std::vector<float> m_error;
+
+            LandmarkFlowStats m_stats;
+    };
+}
+
+#endif // LANDMARKFLOW_H
@@ -0,0 +1,226 @@
+#include "MicroBackend.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "SelectedMicroOps.hpp"  // Generated from the loaded models by "model_surgery ops --micro" (see CMakeLists.txt)
+#include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+#ifndef TF_LITE_STATIC_MEMORY
+#error "The micro build compiles every file with TF_LITE_STATIC_MEMORY (see CMakeLists.txt)"
+#endif
+
+#ifndef __GLIBC__
+#error "The heap check of MicroBackend wraps the glibc allocator (__libc_malloc)"
+#endif
+
+/*
+Upper bound of the arena a model is first planned in (cmake -DTFLM_ARENA_BYTES=...).
+The arena actually kept is then shrunk to what the model used.
+*/
+#ifndef MICRO_ARENA_BYTES
+#define MICRO_ARENA_BYTES (16 * 1024 * 1024)
+#endif
+
+/*
+Alignment slack added to arena_used_bytes() when the arena is shrunk
+*/
+#define MICRO_ARENA_ALIGNMENT 16
+
+
+/*
+Heap check: the malloc family of the program goes through these wrappers
+(operator new, std containers, C code and OpenCV included). While a thread
+runs an invoke, its allocations are counted. TFLM runs every kernel on the
+calling thread (no thread pool), so an allocation of the inference cannot
+happen on another thread.
+*/
+static thread_local bool __countAllocations = false;
+static thread_local size_t __heapAllocations = 0;
+
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* data, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void* data);
+
+    void* malloc(size_t size) {
+        if (__countAllocations)
+            ++__heapAllocations;
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) {
+        if (__countAllocations)
+            ++__heapAllocations;
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* data, size_t size) {
+        if (__countAllocations)
+            ++__heapAllocations;
+        return __libc_realloc(data, size);
+    }
+
+    void* memalign(size_t alignment, size_t size) {
+        if (__countAllocations)
+            ++__heapAllocations;
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) {
+        return memalign(alignment, size);
+    }
+
+    int posix_memalign(void** data, size_t alignment, size_t size) {
+        *data = memalign(alignment, size);
+        return *data == nullptr ? ENOMEM : 0;
+    }
+
+    void free(void* data) {
+        __libc_free(data);
+    }
+}
+
+
+/*
+Helper function: the ops of the loaded models, registered once
+*/
+static const tflite::MicroOpResolver& __getMicroOpResolver() {
+    static const auto resolver = [] {
+        hand::SelectedMicroOpResolver ops;
+        hand::registerSelectedOps(ops);
+        return ops;
+    }();
+    return resolver;
+}
+
+
+std::unique_ptr<hand::ModelBackend> hand::ModelBackend::create(SharedModel model, int numThreads) {
+    return std::unique_ptr<ModelBackend>(new MicroBackend(std::move(model)));
+}
+
+
+hand::SharedModel hand::ModelBackend::loadModel(const std::string& modelPath) {
+    std::ifstream file(modelPath, std::ios::binary);
+    auto model = std::make_shared<MicroModel>();
+    model->bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    flatbuffers::Verifier verifier(model->bytes.data(), model->bytes.size());
+    if (model->bytes.empty() || tflite::VerifyModelBuffer(verifier) == false) {
+        std::cerr << "Fail to read a tflite model from file: " << modelPath << std::endl;
+        std::exit(1);
+    }
+    model->model = tflite::GetModel(model->bytes.data());
+    return model;
+}
+
+
+hand::MicroBackend::MicroBackend(SharedModel model) :
+    m_model(std::move(model))
+{
+    /*
+    Plan in the largest arena, then again in one of the size the model used
+    */
+    std::vector<uint8_t> probe(MICRO_ARENA_BYTES);
+    size_t used = build(probe);
+    m_interpreter.reset();
+
+    m_arena.resize(used + MICRO_ARENA_ALIGNMENT);
+    m_memory.arenaBytes = build(m_arena);
+    m_memory.reservedBytes = m_arena.size();
+    m_memory.weightBytes = measureWeights();
+}
+
+
+std::vector<hand::TensorWrapper> hand::MicroBackend::getInputs() {
+    std::vector<TensorWrapper> tensors;
+    for (size_t i = 0; i < m_interpreter->inputs_size(); ++i) {
+        tensors.push_back(wrapTensor(m_interpreter->input(i)));
+    }
+    return tensors;
+}
+
+
+std::vector<hand::TensorWrapper> hand::MicroBackend::getOutputs() {
+    std::vector<TensorWrapper> tensors;
+    for (size_t i = 0; i < m_interpreter->outputs_size(); ++i) {
+        tensors.push_back(wrapTensor(m_interpreter->output(i)));
+    }
+    return tensors;
+}
+
+
+bool hand::MicroBackend::resizeInput(int index, const std::vector<int>& shape) {
+    return false;
+}
+
+
+bool hand::MicroBackend::invoke() {
+    size_t before = __heapAllocations;
+    __countAllocations = true;
+    bool success = m_interpreter->Invoke() == kTfLiteOk;
+    __countAllocations = false;
+
+    size_t allocations = __heapAllocations - before;
+    if (allocations > 0) {
+        std::cerr << "Micro backend: " << allocations << " heap allocations during inference." << std::endl;
+        std::exit(1);
+    }
+    return success;
+}
+
+
+bool hand::MicroBackend::canReleaseArena() const {
+    return false;
+}
+
+
+void hand::MicroBackend::releaseArena() {}
+
+
+void hand::MicroBackend::acquireArena() {}
+
+
+hand::ModelMemory hand::MicroBackend::getMemoryInfo() const {
+    return m_memory;
+}
+
+//-------------------Private methods start here-------------------
+
+size_t hand::MicroBackend::build(std::vector<uint8_t>& arena) {
+    m_interpreter.reset(new tflite::MicroInterpreter(m_model->model, __getMicroOpResolver(),
+                                                     arena.data(), arena.size(),
+                                                     tflite::GetMicroErrorReporter()));
+    if (m_interpreter->AllocateTensors() != kTfLiteOk) {
+        std::cerr << "Failed to allocate tensors in a " << arena.size() / 1024
+                  << "KB arena (op missing from SelectedMicroOps.hpp or arena too small, see TFLM_ARENA_BYTES)."
+                  << std::endl;
+        std::exit(1);
+    }
+    return m_interpreter->arena_used_bytes();
+}
+
+
+hand::TensorWrapper hand::MicroBackend::wrapTensor(TfLiteTensor* tensor) {
+    return {tensor->data.f, tensor->bytes, tensor->dims->data, tensor->dims->size, tensor->type};
+}
+
+
+size_t hand::MicroBackend::measureWeights() const {
+    size_t bytes = 0;
+    const auto* buffers = m_model->model->buffers();
+    if (buffers == nullptr)
+        return bytes;
+
+    for (auto buffer : *buffers) {
+        if (buffer->data() != nullptr)
+            bytes += buffer->data()->size();
+    }
+    return bytes;
+}
@@ -0,0 +1,71 @@
+#ifndef MICROBACKEND_H
+#define MICROBACKEND_H
+
+#include "ModelBackend.hpp"
+
+#include "tensorflow/lite/micro/micro_interpreter.h"
+
+namespace hand {
+
+    /*
+    ModelBackend of the micro build (Handmap_micro): tflite::MicroInterpreter
+    on one fixed arena per model, sized to the minimum the model needs.
+    Everything is allocated at init; an inference which touches the heap
+    (malloc family or new, see MicroBackend.cpp) exits the program.
+    Inputs cannot be resized (no batching), and only the builtin ops of the
+    loaded models are registered (SelectedMicroOps.hpp): no HandPalmDecode,
+    palm outputs are decoded on the CPU.
+    This class is non-copyable.
+    */
+    class MicroBackend : public ModelBackend {
+        public:
+            /*
+            Parameters:
+                model: model returned by ModelLoader::loadModel()
+            */
+            MicroBackend(SharedModel model);
+            MicroBackend(const MicroBackend& other) = delete;
+            MicroBackend& operator=(const MicroBackend& other) = delete;
+            virtual ~MicroBackend() = default;
+
+            virtual std::vector<TensorWrapper> getInputs();
+            virtual std::vector<TensorWrapper> getOutputs();
+
+            /*
+            The arena is planned for the shapes of the model only: always false.
+            */
+            virtual bool resizeInput(int index, const std::vector<int>& shape);
+
+            virtual bool invoke();
+
+            /*
+            The arena is fixed: nothing to release.
+            */
+            virtual bool canReleaseArena() const;
+            virtual void releaseArena();
+            virtual void acquireArena();
+
+            virtual ModelMemory getMemoryInfo() const;
+
+        private:
+            /*
+            Build the interpreter on arena and allocate its tensors, returns the arena bytes used
+            */
+            size_t build(std::vector<uint8_t>& arena);
+
+            static TensorWrapper wrapTensor(TfLiteTensor* tensor);
+
+            /*
+            Constant buffers of the flatbuffer (read in place, not copied to the arena)
+            */
+            size_t measureWeights() const;
+
+        private:
+            SharedModel m_model;
+            std::vector<uint8_t> m_arena;
+            std::unique_ptr<tflite::MicroInterpreter> m_interpreter;
+            ModelMemory m_memory;
+    };
+}
+
+#endif // MICROBACKEND_H
@@ -0,0 +1,117 @@
+#ifndef MODELBACKEND_H
+#define MODELBACKEND_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/lite/c/common.h"
+
+namespace tflite {
+    class FlatBufferModel;
+    struct Model;
+}
+
+namespace hand {
+
+    /*
+    A tensor wrapper to save information of tflite tensors.
+    Attributes:
+        data: a float pointer to tensor data
+        bytes: size of data in bytes
+        dims: shape of data tensor
+        type: element type (data is only floats for kTfLiteFloat32)
+    */
+    struct TensorWrapper {
+        float* data;
+        size_t bytes;
+        std::vector<int> dims;
+        TfLiteType type;
+
+        TensorWrapper(float* t_data, size_t t_bytes, int* t_dims, int t_dimSize, TfLiteType t_type = kTfLiteFloat32):
+            data(t_data), bytes(t_bytes), dims(t_dims, t_dims + t_dimSize), type(t_type) {}
+    };
+
+    /*
+    Memory of one interpreter, as planned by AllocateTensors.
+    Attributes:
+        arenaBytes: intermediate tensors, inputs and outputs (freed between inferences with a shared arena),
+                    for the micro backend: the smallest arena the model runs in
+        persistentBytes: tensors kept for the interpreter lifetime (variables, op state)
+        weightBytes: constant tensors, read from the model file (shared between interpreters)
+        reservedBytes: arena memory actually held (the fixed arena of the micro backend)
+    (Note: buffers of delegates, e.g. XNNPACK packed weights, are not counted)
+    */
+    struct ModelMemory {
+        size_t arenaBytes = 0;
+        size_t persistentBytes = 0;
+        size_t weightBytes = 0;
+        size_t reservedBytes = 0;
+    };
+
+#if WITH_TFLM
+    /*
+    Micro build: the bytes of a .tflite file (no FlatBufferModel without the full TFLite)
+    Attributes:
+        bytes: content of the file
+        model: root of the flatbuffer, points into bytes
+    */
+    struct MicroModel {
+        std::vector<uint8_t> bytes;
+        const tflite::Model* model = nullptr;
+    };
+
+    using SharedModel = std::shared_ptr<const MicroModel>;
+#else
+    using SharedModel = std::shared_ptr<tflite::FlatBufferModel>;
+#endif
+
+    /*
+    The part of ModelLoader which depends on the runtime, chosen by the build:
+        InterpreterBackend: tflite::Interpreter, dynamic allocation, XNNPACK (Handmap)
+        MicroBackend: tflite::MicroInterpreter on one fixed arena, no heap after init
+                      (Handmap_micro, cmake -DWITH_TFLM=ON)
+    The two are never linked together: TFLM and the full TFLite define the same
+    symbols with two layouts of TfLiteTensor (TF_LITE_STATIC_MEMORY).
+    */
+    class ModelBackend {
+        public:
+            virtual ~ModelBackend() = default;
+
+            /*
+            Wrappers of the input / output tensors, valid until the next resize or arena release
+            */
+            virtual std::vector<TensorWrapper> getInputs() = 0;
+            virtual std::vector<TensorWrapper> getOutputs() = 0;
+
+            /*
+            Resize input at index and reallocate. On failure the previous shape is kept.
+            */
+            virtual bool resizeInput(int index, const std::vector<int>& shape) = 0;
+
+            virtual bool invoke() = 0;
+
+            /*
+            Free the arena between inferences / allocate it again (see ModelLoader::setSharedArena())
+            */
+            virtual bool canReleaseArena() const = 0;
+            virtual void releaseArena() = 0;
+            virtual void acquireArena() = 0;
+
+            virtual ModelMemory getMemoryInfo() const = 0;
+
+            /*
+            Build the backend of this build for model (defined by InterpreterBackend.cpp or MicroBackend.cpp).
+            numThreads: number of threads used by the interpreter (-1: let tflite decide, ignored by micro)
+            */
+            static std::unique_ptr<ModelBackend> create(SharedModel model, int numThreads = -1);
+
+            /*
+            Load a .tflite file so it can be shared between several backends (exits on failure).
+            */
+            static SharedModel loadModel(const std::string& modelPath);
+    };
+}
+
+#endif // MODELBACKEND_H
@@ -1,20 +1,21 @@
 #include "ModelLoader.hpp"
+#include "FrameConvert.hpp"
 
 #include <iostream>
 
-#include "tensorflow/lite/builtin_op_data.h"
-#include "tensorflow/lite/kernels/register.h"
-
 #define INPUT_NORM_MEAN 127.5f
 #define INPUT_NORM_STD  127.5f
 
 
-hand::ModelLoader::ModelLoader(std::string modelPath) {
-    loadModel(modelPath.c_str());
-    buildInterpreter();
-    allocateTensors();
-    fillInputTensors();
-    fillOutputTensors();
+hand::ModelLoader::ModelLoader(std::string modelPath, int numThreads) :
+    ModelLoader(loadModel(modelPath), numThreads)
+{}
+
+
+hand::ModelLoader::ModelLoader(SharedModel model, int numThreads) :
+    m_backend(ModelBackend::create(std::move(model), numThreads)), m_sharedArena(false), m_released(false)
+{
+    fillTensors();
 
     m_inputLoads.resize(getNumberOfInputs(), false);
 }
@@ -49,6 +50,11 @@ int hand::ModelLoader::getNumberOfInputs() const {
 }
 
 
+bool hand::ModelLoader::isRawInput(int index) const {
+    return isIndexValid(index, 'i') && m_inputs[index].type == kTfLiteUInt8;
+}
+
+
 std::vector<int> hand::ModelLoader::getOutputShape(int index) const {
     if (isIndexValid(index, 'o'))
         return m_outputs[index].dims;
@@ -78,15 +84,82 @@ int hand::ModelLoader::getNumberOfOutputs() const {
 }
 
 
+bool hand::ModelLoader::setBatchSize(int batchSize, int idx) {
+    if (isIndexValid(idx, 'i') == false || batchSize < 1)
+        return false;
+    acquireArena();
+
+    std::vector<int> previous = getInputShape(idx);
+    if (previous[0] == batchSize)
+        return true;
+
+    std::vector<int> shape = previous;
+    shape[0] = batchSize;
+
+    bool resized = m_backend->resizeInput(idx, shape);
+    if (resized == false)
+        std::cerr << "Model cannot run a batch of " << batchSize << ", keeping " << previous[0] << "." << std::endl;
+
+    fillTensors();
+    return resized;
+}
+
+
+int hand::ModelLoader::getBatchSize(int index) const {
+    std::vector<int> shape = getInputShape(index);
+    return shape.empty() ? 0 : shape[0];
+}
+
+
 void hand::ModelLoader::loadImageToInput(const cv::Mat& inputImage, int idx) {
-    if (isIndexValid(idx, 'i')) {
+    loadImageToBatch(inputImage, 0, idx);
+}
+
+
+void hand::ModelLoader::loadImageToBatch(const cv::Mat& inputImage, int slot, int idx) {
+    acquireArena();
+    uchar* data = getSlotData(slot, idx);
+    if (data == nullptr)
+        return;
+
+    if (isRawInput(idx)) {
+        loadImageBytes(inputImage, data, idx);
+    }
+    else {
         cv::Mat resizedImage = preprocessImage(inputImage, idx); // Need optimize
-        loadBytesToInput(resizedImage.data, idx);
+        memcpy(data, resizedImage.data, m_inputs[idx].bytes / m_inputs[idx].dims[0]);
     }
+    m_inputLoads[idx] = true;
+}
+
+
+void hand::ModelLoader::loadFrameToInput(const Frame& frame, int idx) {
+    loadFrameRoiToInput(frame, cv::Rect(), idx);
+}
+
+
+void hand::ModelLoader::loadFrameRoiToInput(const Frame& frame, const cv::Rect& roi, int idx) {
+    loadFrameRoiToBatch(frame, roi, 0, idx);
+}
+
+
+void hand::ModelLoader::loadFrameRoiToBatch(const Frame& frame, const cv::Rect& roi, int slot, int idx) {
+    acquireArena();
+    uchar* data = getSlotData(slot, idx);
+    if (data == nullptr)
+        return;
+
+    std::vector<int> inputShape = getInputShape(idx);
+    if (isRawInput(idx))
+        frameToBytes(frame, roi, data, inputShape[2], inputShape[1]);
+    else
+        frameToTensor(frame, roi, (float*)data, inputShape[2], inputShape[1], INPUT_NORM_MEAN, INPUT_NORM_STD);
+    m_inputLoads[idx] = true;
 }
 
 
 void hand::ModelLoader::loadBytesToInput(const void* data, int idx) {
+    acquireArena();
     if (isIndexValid(idx, 'i')) {
         memcpy(m_inputs[idx].data, data, m_inputs[idx].bytes);
         m_inputLoads[idx] = true;
@@ -96,7 +169,11 @@ void hand::ModelLoader::loadBytesToInput(const void* data, int idx) {
 
 void hand::ModelLoader::runInference() {
     inputChecker();
-    m_interpreter->Invoke(); // Tflite inference
+    if (m_backend->invoke() == false)
+        std::cerr << "Failed to run inference." << std::endl;
+
+    if (m_sharedArena)
+        releaseArena();
 }
 
 
@@ -111,63 +188,106 @@ std::vector<float> hand::ModelLoader::loadOutput(int index) const {
 }
 
 
+void hand::ModelLoader::setSharedArena(bool shared) {
+    m_sharedArena = shared && m_backend->canReleaseArena();
+    if (shared == false)
+        acquireArena();
+}
+
+
+bool hand::ModelLoader::isSharedArena() const {
+    return m_sharedArena;
+}
+
+
+hand::ModelMemory hand::ModelLoader::getMemoryInfo() const {
+    return m_backend->getMemoryInfo();
+}
+
+
+hand::SharedModel hand::ModelLoader::loadModel(const std::string& modelPath) {
+    return ModelBackend::loadModel(modelPath);
+}
+
+
 //-------------------Private methods start here-------------------
 
-void hand::ModelLoader::loadModel(const char* modelPath) {
-    m_model = tflite::FlatBufferModel::BuildFromFile(modelPath);
-    if (m_model == nullptr) {
-        std::cerr << "Fail to build FlatBufferModel from file: " << modelPath << std::endl;
-        std::exit(1);
-    }  
+
+void hand::ModelLoader::fillTensors() {
+    m_inputs = m_backend->getInputs();
+    m_outputs = m_backend->getOutputs();
 }
 
 
-void hand::ModelLoader::buildInterpreter(int numThreads) {
-    tflite::ops::builtin::BuiltinOpResolver resolver;
+void hand::ModelLoader::releaseArena() {
+    if (m_released)
+        return;
 
-    if (tflite::InterpreterBuilder(*m_model, resolver)(&m_interpreter) != kTfLiteOk) {
-        std::cerr << "Failed to build interpreter." << std::endl;
-        std::exit(1);
+    /*
+    Outputs live in the arena: keep a copy, readers go through m_outputs
+    */
+    m_outputCopies.resize(m_outputs.size());
+    for (int i = 0; i < (int)m_outputs.size(); ++i) {
+        m_outputCopies[i].resize((m_outputs[i].bytes + sizeof(float) - 1) / sizeof(float));
+        memcpy(m_outputCopies[i].data(), m_outputs[i].data, m_outputs[i].bytes);
+        m_outputs[i].data = m_outputCopies[i].data();
     }
-    m_interpreter->SetNumThreads(numThreads);
+
+    m_backend->releaseArena();
+    for (auto& input : m_inputs) {
+        input.data = nullptr;
+    }
+    m_released = true;
 }
 
 
-void hand::ModelLoader::allocateTensors() {
-    if (m_interpreter->AllocateTensors() != kTfLiteOk) {
-        std::cerr << "Failed to allocate tensors." << std::endl;
-        std::exit(1);
-    }
+void hand::ModelLoader::acquireArena() {
+    if (m_released == false)
+        return;
+
+    m_backend->acquireArena();
+    fillTensors();
+    m_released = false;
 }
 
 
-void hand::ModelLoader::fillInputTensors() {
-    for (auto input: m_interpreter->inputs()) {
-        TfLiteTensor* inputTensor =  m_interpreter->tensor(input);
-        TfLiteIntArray* dims =  inputTensor->dims;
+uchar* hand::ModelLoader::getSlotData(int slot, int idx) const {
+    if (isIndexValid(idx, 'i') == false)
+        return nullptr;
 
-        m_inputs.push_back({
-            inputTensor->data.f,
-            inputTensor->bytes,
-            dims->data,
-            dims->size
-        });
+    int batchSize = m_inputs[idx].dims[0];
+    if (slot < 0 || slot >= batchSize) {
+        std::cerr << "Batch slot " << slot << " is out of range (" << batchSize << ")." << std::endl;
+        return nullptr;
     }
+    return (uchar*)m_inputs[idx].data + slot * (m_inputs[idx].bytes / batchSize);
 }
 
 
-void hand::ModelLoader::fillOutputTensors() {
-    for (auto output: m_interpreter->outputs()) {
-        TfLiteTensor* outputTensor =  m_interpreter->tensor(output);
-        TfLiteIntArray* dims =  outputTensor->dims;
+void hand::ModelLoader::loadImageBytes(const cv::Mat& in, uchar* data, int idx) const {
+    std::vector<int> inputShape = getInputShape(idx);
+    cv::Mat slot(inputShape[1], inputShape[2], CV_8UC3, data);
 
-        m_outputs.push_back({
-            outputTensor->data.f,
-            outputTensor->bytes,
-            dims->data,
-            dims->size
-        });
+    /*
+    Written in place: cv::resize / cvtColor / copyTo reuse a destination of the right size and type
+    */
+    cv::Mat bgr = in;
+    if (in.type() == CV_8UC4) {
+        if (in.size() == slot.size()) {
+            cv::cvtColor(in, slot, cv::COLOR_BGRA2BGR);
+            return;
+        }
+        cv::cvtColor(in, bgr, cv::COLOR_BGRA2BGR);
+    }
+    else if (in.type() != CV_8UC3) {
+        std::cerr << "Image of type " << in.type() << " not supported" << std::endl;
+        std::exit(1);
     }
+
+    if (bgr.size() == slot.size())
+        bgr.copyTo(slot);
+    else
+        cv::resize(bgr, slot, slot.size());
 }
 
 
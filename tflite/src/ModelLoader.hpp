@@ -5,32 +5,17 @@
 #include <memory>
 #include <string>
 
+#include "FrameSource.hpp"
+#include "ModelBackend.hpp"
+
 #include "opencv2/core.hpp"
 #include "opencv2/imgproc.hpp"
-#include "tensorflow/lite/interpreter.h"
-#include "tensorflow/lite/model.h"
 
 namespace hand {
 
     template <class T>
     using Matrix = std::vector<std::vector<T>>;
 
-    /*
-    A tensor wrapper to save information of tflite tensors.
-    Attributes:
-        data: a float pointer to tensor data
-        bytes: size of data in bytes
-        dims: shape of data tensor
-    */
-    struct TensorWrapper {
-        float* data;
-        size_t bytes;
-        std::vector<int> dims;
-
-        TensorWrapper(float* t_data, size_t t_bytes, int* t_dims, int t_dimSize): 
-            data(t_data), bytes(t_bytes), dims(t_dims, t_dims + t_dimSize) {}
-    };
-
     /*
     A model wrapper to simplify the procedure of using tflite's models.
     This class is non-copyable.
@@ -41,8 +26,19 @@ namespace hand {
             Constructor from a .tflite file
             Parameters:
                 modelPath: path to .tflite
+                numThreads: number of threads used by the interpreter (-1: let tflite decide)
             */
-            ModelLoader(std::string modelPath);
+            ModelLoader(std::string modelPath, int numThreads = -1);
+
+            /*
+            Constructor from an already loaded model.
+            The model is read-only, so many interpreters (one per ModelLoader)
+            can share a single copy of it.
+            Parameters:
+                model: model returned by ModelLoader::loadModel()
+                numThreads: number of threads used by the interpreter (-1: let tflite decide)
+            */
+            ModelLoader(SharedModel model, int numThreads = -1);
             ModelLoader(const ModelLoader& other) = delete;
             ModelLoader& operator=(const ModelLoader& other) = delete;
             virtual ~ModelLoader() = default;
@@ -76,6 +72,28 @@ namespace hand {
             */
             int getNumberOfInputs() const;
 
+            /*
+            True if input tensor at index takes raw uint8 BGR pixels, i.e. the model
+            does color conversion, resize and normalization itself (see the
+            "preprocess" command of tools/ModelSurgery.cpp).
+            Images and frames are then only resized (if needed) and copied as bytes.
+            */
+            bool isRawInput(int index = 0) const;
+
+            /*
+            Resize input tensor at index to a batch of batchSize images (its first
+            dimension) and reallocate the tensors, so one invoke runs them all.
+            Models which cannot run batched (e.g. a Reshape to a fixed batch of 1)
+            keep their previous shape, and false is returned (always in the micro build).
+            (Note: data pointers of inputs and outputs change)
+            */
+            bool setBatchSize(int batchSize, int index = 0);
+
+            /*
+            First dimension of input tensor at index.
+            */
+            int getBatchSize(int index = 0) const;
+
             /*
             Get shape of output tensor at index.
             (Note: A model can have multiple outputs)
@@ -111,6 +129,25 @@ namespace hand {
             */
             virtual void loadImageToInput(const cv::Mat& inputImage, int index = 0);
 
+            /*
+            Load a captured frame (BGR, YUYV or NV12) to model at index.
+            Color conversion, resize and normalization are done in one pass
+            straight into the input tensor (see frameToTensor()).
+            */
+            virtual void loadFrameToInput(const Frame& frame, int index = 0);
+
+            /*
+            Same as loadFrameToInput() for roi of frame only (padded with black out of the frame).
+            */
+            void loadFrameRoiToInput(const Frame& frame, const cv::Rect& roi, int index = 0);
+
+            /*
+            Load an image / roi of a frame into slot of a batched input at index
+            (see setBatchSize()). Every slot must be loaded before runInference().
+            */
+            void loadImageToBatch(const cv::Mat& inputImage, int slot, int index = 0);
+            void loadFrameRoiToBatch(const Frame& frame, const cv::Rect& roi, int slot, int index = 0);
+
             /*
             Load byte data to model at index
             */
@@ -128,16 +165,53 @@ namespace hand {
             */
             virtual std::vector<float> loadOutput(int index = 0) const;
 
+            /*
+            Shared arena mode, for models run strictly one after the other (e.g. palm
+            detection then landmarks): after each inference the outputs are copied out
+            and the arena of the intermediate tensors is released, then allocated again
+            by the next load (same plan, no replanning). The interpreters taking turns
+            then hold one arena at a time, the largest, instead of all of them.
+            Costs one arena allocation and an output copy per inference.
+            Ignored in the micro build, whose arena is fixed.
+            (Note: getInputData() is nullptr between an inference and the next load)
+            */
+            virtual void setSharedArena(bool shared);
+            bool isSharedArena() const;
+
+            /*
+            Memory planned for this interpreter (arena sizes measured at the last allocation).
+            In the micro build, arenaBytes is the smallest arena the model needs.
+            */
+            virtual ModelMemory getMemoryInfo() const;
+
+            /*
+            Load a .tflite file so it can be shared between several ModelLoader.
+            */
+            static SharedModel loadModel(const std::string& modelPath);
+
 
         private:
             /*
-            Constructor helper functions
+            Refresh m_inputs / m_outputs from the backend
             */
-            void loadModel(const char* modelPath);
-            void buildInterpreter(int numThreads = -1);
-            void allocateTensors();           
-            void fillInputTensors();
-            void fillOutputTensors();
+            void fillTensors();
+
+            /*
+            Shared arena: copy the outputs and free the arena / allocate it again
+            (refreshing the tensor wrappers) before the next load
+            */
+            void releaseArena();
+            void acquireArena();
+
+            /*
+            Data of one image of the batch in input tensor at index (nullptr if slot is out of range)
+            */
+            uchar* getSlotData(int slot, int index) const;
+
+            /*
+            Write image into a raw input slot (see isRawInput())
+            */
+            void loadImageBytes(const cv::Mat& in, uchar* data, int idx) const;
 
             /*
             Check if index is valid for input and output tensor
@@ -177,19 +251,21 @@ namespace hand {
             std::vector<TensorWrapper> m_outputs;
 
             /*
-            TFLite core
+            TFLite core (the backend keeps the model, which may be shared with other ModelLoader)
             */
-            std::unique_ptr<tflite::FlatBufferModel> m_model;
-
-            /*
-            TFLite core
-            */           
-            std::unique_ptr<tflite::Interpreter> m_interpreter;
+            std::unique_ptr<ModelBackend> m_backend;
 
             /*
             Tracking inputs loaded
             */
             std::vector<bool> m_inputLoads;
+
+            /*
+            Shared arena state: outputs of the last inference while the arena is released
+            */
+            bool m_sharedArena;
+            bool m_released;
+            std::vector<std::vector<float>> m_outputCopies;
     };
 };
 
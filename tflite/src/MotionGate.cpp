@@ -0,0 +1,115 @@
+#include "MotionGate.hpp"
+
+#include <chrono>
+
+
+hand::MotionGate::MotionGate(int keepAliveFrames, float minArea) :
+    m_keepAliveFrames(keepAliveFrames), m_minArea(minArea), m_isAvgInit(false),
+    m_motionArea(0.f), m_framesSinceRun(0), m_handPresent(false),
+    m_gateSumMs(0.0), m_inferenceSumMs(0.0), m_inferences(0)
+{}
+
+
+bool hand::MotionGate::shouldRun(const cv::Mat& frame) {
+    auto start = std::chrono::steady_clock::now();
+    float area = computeMotionArea(frame);
+    double gateMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_motionArea = area;
+    m_stats.frames++;
+    m_gateSumMs += gateMs;
+
+    bool run = true;
+    if (m_handPresent) {
+        m_stats.tracking++;
+    }
+    else if (area >= m_minArea) {
+        m_stats.opened++;
+    }
+    else if (m_framesSinceRun + 1 >= m_keepAliveFrames) {
+        m_stats.keepAlive++;
+    }
+    else {
+        m_stats.skipped++;
+        run = false;
+    }
+
+    m_framesSinceRun = run ? 0 : m_framesSinceRun + 1;
+    return run;
+}
+
+
+void hand::MotionGate::setHandPresent(bool present) {
+    m_handPresent = present;
+}
+
+
+void hand::MotionGate::reportInference(double inferenceMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_inferenceSumMs += inferenceMs;
+    m_inferences++;
+}
+
+
+float hand::MotionGate::getMotionArea() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_motionArea;
+}
+
+
+cv::Mat hand::MotionGate::getMotionMask() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_mask.clone();
+}
+
+
+hand::MotionGateStats hand::MotionGate::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    MotionGateStats stats = m_stats;
+
+    if (stats.frames > 0)
+        stats.avgGateMs = m_gateSumMs / stats.frames;
+    if (m_inferences > 0)
+        stats.avgInferenceMs = m_inferenceSumMs / m_inferences;
+
+    stats.savedMs = stats.skipped * stats.avgInferenceMs - m_gateSumMs;
+    return stats;
+}
+
+//-------------------Private methods start here-------------------
+
+float hand::MotionGate::computeMotionArea(const cv::Mat& frame) {
+    /*
+    Same steps as the opencv2 swipe detector, on a small frame:
+    the gate must stay far cheaper than the inference it saves.
+    */
+    double scale = (double)MOTION_GATE_WIDTH / frame.cols;
+    cv::Mat small;
+    cv::resize(frame, small, cv::Size(), scale, scale, cv::INTER_AREA);
+
+    cv::cvtColor(small, m_gray, small.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+    cv::GaussianBlur(m_gray, m_gray, cv::Size(5, 5), 0);
+
+    if (m_isAvgInit == false || m_avgFloat.size() != m_gray.size()) {
+        m_gray.convertTo(m_avgFloat, CV_32F);
+        m_isAvgInit = true;
+    }
+
+    cv::accumulateWeighted(m_gray, m_avgFloat, MOTION_GATE_ALPHA);
+    m_avgFloat.convertTo(m_avgGray, CV_8U);
+
+    cv::absdiff(m_gray, m_avgGray, m_diff);
+    cv::Mat mask;
+    cv::threshold(m_diff, mask, MOTION_GATE_THRESHOLD, 255, cv::THRESH_BINARY);
+    cv::erode(mask, mask, cv::Mat(), cv::Point(-1, -1), 1);
+    cv::dilate(mask, mask, cv::Mat(), cv::Point(-1, -1), 1);
+
+    float area = (float)cv::countNonZero(mask) / mask.total();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_mask = mask;
+    }
+    return area;
+}
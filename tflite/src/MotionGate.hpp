@@ -0,0 +1,110 @@
+#ifndef MOTIONGATE_H
+#define MOTIONGATE_H
+
+#include <atomic>
+#include <mutex>
+
+#include "opencv2/core.hpp"
+#include "opencv2/imgproc.hpp"
+
+#define MOTION_GATE_WIDTH        160    // The background model runs on a frame this wide
+#define MOTION_GATE_ALPHA        0.05   // Background learning rate (accumulateWeighted)
+#define MOTION_GATE_THRESHOLD    40     // Gray level difference counted as motion
+#define MOTION_GATE_MIN_AREA     0.005f // Fraction of moving pixels which opens the gate
+#define MOTION_GATE_KEEP_ALIVE   30     // Frames between two forced inferences
+
+namespace hand {
+
+    /*
+    Counters of a MotionGate.
+    Attributes:
+        frames: frames given to shouldRun()
+        opened: frames let through because of motion
+        keepAlive: frames let through because nothing ran for too long
+        tracking: frames let through because a hand was present
+        skipped: frames for which inference was not needed
+        avgGateMs: mean cost of the gate itself
+        avgInferenceMs: mean cost of an inference, from reportInference()
+        savedMs: estimated inference time saved (skipped * avgInferenceMs - gate cost)
+    */
+    struct MotionGateStats {
+        size_t frames = 0;
+        size_t opened = 0;
+        size_t keepAlive = 0;
+        size_t tracking = 0;
+        size_t skipped = 0;
+        double avgGateMs = 0.0;
+        double avgInferenceMs = 0.0;
+        double savedMs = 0.0;
+    };
+
+    /*
+    A cheap motion detector put in front of HandDetection.
+    It is the running average background of the opencv2 swipe detector
+    (accumulateWeighted, absdiff, threshold) on a downscaled gray frame.
+    Neural inference is only needed when something moves, when a hand is
+    already present, or every MOTION_GATE_KEEP_ALIVE frames.
+    shouldRun() and reportInference()/setHandPresent() may be called from different threads.
+    */
+    class MotionGate {
+        public:
+            MotionGate(int keepAliveFrames = MOTION_GATE_KEEP_ALIVE, float minArea = MOTION_GATE_MIN_AREA);
+
+            /*
+            Update the background with frame (BGR) and decide if inference should run on it.
+            */
+            bool shouldRun(const cv::Mat& frame);
+
+            /*
+            Tell the gate whether the last inference found a hand.
+            A still hand does not move, but its landmarks are still wanted.
+            */
+            void setHandPresent(bool present);
+
+            /*
+            Report the duration of an inference let through, used to estimate savings.
+            */
+            void reportInference(double inferenceMs);
+
+            /*
+            Get the fraction of moving pixels in the last frame.
+            */
+            float getMotionArea() const;
+
+            /*
+            Get the last motion mask (MOTION_GATE_WIDTH wide, CV_8UC1).
+            */
+            cv::Mat getMotionMask() const;
+
+            MotionGateStats getStats() const;
+
+        private:
+            float computeMotionArea(const cv::Mat& frame);
+
+        private:
+            int m_keepAliveFrames;
+            float m_minArea;
+
+            /*
+            Background model
+            */
+            cv::Mat m_gray;
+            cv::Mat m_avgFloat;
+            cv::Mat m_avgGray;
+            cv::Mat m_diff;
+            cv::Mat m_mask;
+            bool m_isAvgInit;
+
+            float m_motionArea;
+            int m_framesSinceRun;
+            std::atomic<bool> m_handPresent;
+
+            MotionGateStats m_stats;
+            double m_gateSumMs;
+            double m_inferenceSumMs;
+            size_t m_inferences;
+            mutable std::mutex m_mutex;
+    };
+}
+
+#endif // MOTIONGATE_H
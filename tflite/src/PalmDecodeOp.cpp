@@ -0,0 +1,139 @@
+#include "PalmDecodeOp.hpp"
+#include "DetectionPostProcess.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+
+#include "flatbuffers/flexbuffers.h"
+
+
+namespace {
+
+    /*
+    State of one op node, built once by init()
+    */
+    struct PalmDecodeData {
+        hand::DetectionPostProcess postProcessor;
+        float scoreThreshold = MIN_THRESHOLD;
+        float iouThreshold = PALM_DECODE_IOU_THRESHOLD;
+        int maxDetections = PALM_DECODE_MAX_DETECTIONS;
+    };
+}
+
+
+/*
+Helper functions
+*/
+static TfLiteTensor* __getTensor(TfLiteContext* context, const TfLiteIntArray* indices, int i) {
+    return &context->tensors[indices->data[i]];
+}
+
+
+static TfLiteStatus __resize(TfLiteContext* context, TfLiteTensor* tensor, std::initializer_list<int> shape) {
+    TfLiteIntArray* dims = TfLiteIntArrayCreate(shape.size());
+    std::copy(shape.begin(), shape.end(), dims->data);
+    return context->ResizeTensor(context, tensor, dims); // Takes ownership of dims
+}
+
+
+static void* __init(TfLiteContext* context, const char* buffer, size_t length) {
+    PalmDecodeData* data = new PalmDecodeData();
+    if (buffer != nullptr && length > 0) {
+        auto options = flexbuffers::GetRoot(reinterpret_cast<const uint8_t*>(buffer), length).AsMap();
+        if (options["score_threshold"].IsNull() == false)
+            data->scoreThreshold = options["score_threshold"].AsFloat();
+        if (options["iou_threshold"].IsNull() == false)
+            data->iouThreshold = options["iou_threshold"].AsFloat();
+        if (options["max_detections"].IsNull() == false)
+            data->maxDetections = std::max(1, (int)options["max_detections"].AsInt32());
+    }
+    return data;
+}
+
+
+static void __free(TfLiteContext* context, void* buffer) {
+    delete reinterpret_cast<PalmDecodeData*>(buffer);
+}
+
+
+static TfLiteStatus __prepare(TfLiteContext* context, TfLiteNode* node) {
+    const PalmDecodeData* data = reinterpret_cast<const PalmDecodeData*>(node->user_data);
+    if (node->inputs->size != 2 || node->outputs->size != 2) {
+        context->ReportError(context, "%s: expects 2 inputs and 2 outputs.", PALM_DECODE_OP_NAME);
+        return kTfLiteError;
+    }
+
+    const TfLiteTensor* boxes = __getTensor(context, node->inputs, 0);
+    const TfLiteTensor* scores = __getTensor(context, node->inputs, 1);
+    if (boxes->type != kTfLiteFloat32 || scores->type != kTfLiteFloat32
+     || boxes->dims->size != 3 || boxes->dims->data[1] != NUM_BOXES || boxes->dims->data[2] != NUM_COORD
+     || scores->dims->size < 2 || scores->dims->data[0] != boxes->dims->data[0] || scores->dims->data[1] != NUM_BOXES) {
+        context->ReportError(context, "%s: inputs must be float [batch, %d, %d] and [batch, %d, 1].",
+                             PALM_DECODE_OP_NAME, NUM_BOXES, NUM_COORD, NUM_BOXES);
+        return kTfLiteError;
+    }
+
+    /*
+    Outputs follow the batch of the inputs (see ModelLoader::setBatchSize())
+    */
+    const int batch = boxes->dims->data[0];
+    TfLiteTensor* detections = __getTensor(context, node->outputs, 0);
+    TfLiteTensor* counts = __getTensor(context, node->outputs, 1);
+    detections->type = kTfLiteFloat32;
+    counts->type = kTfLiteFloat32;
+
+    TfLiteStatus status = __resize(context, detections, {batch, data->maxDetections, PALM_DECODE_NUM_VALUES});
+    if (status != kTfLiteOk)
+        return status;
+    return __resize(context, counts, {batch});
+}
+
+
+static TfLiteStatus __invoke(TfLiteContext* context, TfLiteNode* node) {
+    const PalmDecodeData* data = reinterpret_cast<const PalmDecodeData*>(node->user_data);
+    const TfLiteTensor* boxes = __getTensor(context, node->inputs, 0);
+    const TfLiteTensor* scores = __getTensor(context, node->inputs, 1);
+    TfLiteTensor* detections = __getTensor(context, node->outputs, 0);
+    TfLiteTensor* counts = __getTensor(context, node->outputs, 1);
+
+    const int batch = boxes->dims->data[0];
+    const int rowsPerImage = data->maxDetections * PALM_DECODE_NUM_VALUES;
+    std::memset(detections->data.f, 0, detections->bytes);
+
+    for (int b = 0; b < batch; ++b) {
+        const float* rawBoxes = boxes->data.f + b * NUM_BOXES * NUM_COORD;
+        const float* rawScores = scores->data.f + b * NUM_BOXES;
+
+        auto candidates = data->postProcessor.getDetections(rawBoxes, rawScores, data->scoreThreshold);
+        auto kept = hand::nonMaxSuppression(std::move(candidates), data->iouThreshold);
+        int count = std::min((int)kept.size(), data->maxDetections);
+
+        float* out = detections->data.f + b * rowsPerImage;
+        for (int i = 0; i < count; ++i, out += PALM_DECODE_NUM_VALUES) {
+            const hand::Detection& detection = kept[i];
+            out[0] = detection.score;
+            out[1] = detection.roi.x;
+            out[2] = detection.roi.y;
+            out[3] = detection.roi.width;
+            out[4] = detection.roi.height;
+
+            /*
+            Keypoints are only decoded for the hands which are kept
+            */
+            auto keypoints = data->postProcessor.decodeKeypoints(rawBoxes, detection.anchor);
+            for (int k = 0; k < NUM_KEYPOINTS; ++k) {
+                out[5 + 2 * k] = keypoints[k].x;
+                out[6 + 2 * k] = keypoints[k].y;
+            }
+        }
+        counts->data.f[b] = count;
+    }
+    return kTfLiteOk;
+}
+
+
+TfLiteRegistration* hand::registerPalmDecodeOp() {
+    static TfLiteRegistration registration = {__init, __free, __prepare, __invoke};
+    return &registration;
+}
@@ -0,0 +1,33 @@
+#ifndef PALMDECODEOP_H
+#define PALMDECODEOP_H
+
+#include "tensorflow/lite/c/common.h"
+
+#define PALM_DECODE_OP_NAME             "HandPalmDecode"
+#define PALM_DECODE_NUM_VALUES          19      // score, x, y, w, h, 7 keypoints (x, y)
+#define PALM_DECODE_MAX_DETECTIONS      4       // Rows of the detections output
+#define PALM_DECODE_IOU_THRESHOLD       0.3f
+
+namespace hand {
+
+    /*
+    Custom op "HandPalmDecode": anchor decoding, thresholding and NMS of the
+    palm detection model, run inside the interpreter.
+    Inputs:
+        0: raw boxes [batch, NUM_BOXES, NUM_COORD]
+        1: scores [batch, NUM_BOXES, 1]
+    Outputs:
+        0: detections [batch, max_detections, PALM_DECODE_NUM_VALUES], best first,
+           box and keypoints relative to the model input [0..1]
+        1: number of valid rows of each image [batch] (float)
+    Options (flexbuffer map, all optional):
+        score_threshold (MIN_THRESHOLD), iou_threshold (PALM_DECODE_IOU_THRESHOLD),
+        max_detections (PALM_DECODE_MAX_DETECTIONS)
+
+    The op is appended to the palm model by tools/ModelSurgery.cpp and
+    registered by ModelLoader, so the model outputs only the final hands.
+    */
+    TfLiteRegistration* registerPalmDecodeOp();
+}
+
+#endif // PALMDECODEOP_H
@@ -0,0 +1,119 @@
+#include "Renderer.hpp"
+
+#include <chrono>
+
+#include "opencv2/highgui.hpp"
+#include "opencv2/imgproc.hpp"
+
+
+hand::Renderer::Renderer(bool enabled) : m_enabled(enabled), m_running(false), m_quit(false) {
+    if (m_enabled) {
+        m_running = true;
+        m_thread = std::thread(&Renderer::run, this);
+    }
+}
+
+
+hand::Renderer::~Renderer() {
+    stop();
+}
+
+
+bool hand::Renderer::isEnabled() const {
+    return m_enabled;
+}
+
+
+void hand::Renderer::post(RenderFrame frame) {
+    if (m_enabled == false)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.posted++;
+        auto it = m_mailbox.find(frame.window);
+        if (it != m_mailbox.end()) {
+            m_stats.replaced++;
+            it->second = std::move(frame);
+        }
+        else {
+            std::string window = frame.window;
+            m_mailbox.emplace(std::move(window), std::move(frame));
+        }
+    }
+    m_ready.notify_one();
+}
+
+
+bool hand::Renderer::isQuitRequested() const {
+    return m_quit;
+}
+
+
+void hand::Renderer::stop() {
+    m_running = false;
+    m_ready.notify_one();
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+
+hand::RendererStats hand::Renderer::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+//-------------------Private methods start here-------------------
+
+void hand::Renderer::run() {
+    const auto period = std::chrono::milliseconds(1000 / RENDER_DISPLAY_FPS);
+    std::map<std::string, RenderFrame> frames;
+    cv::Mat canvas;
+
+    while (m_running) {
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_ready.wait_for(lock, period, [this] { return m_mailbox.empty() == false || m_running == false; });
+            frames.swap(m_mailbox);
+            m_mailbox.clear();
+        }
+
+        for (const auto& entry : frames) {
+            draw(entry.second, canvas);
+            cv::imshow(entry.first, canvas);
+        }
+        if (frames.empty() == false) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.displayed += frames.size();
+        }
+        frames.clear();
+
+        /*
+        waitKey also paces the display: never faster than RENDER_DISPLAY_FPS.
+        */
+        auto spent = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        int wait = (int)std::max<long long>(1, (period - spent).count());
+        if (cv::waitKey(wait) == 27)
+            m_quit = true;
+    }
+    cv::destroyAllWindows();
+}
+
+
+void hand::Renderer::draw(const RenderFrame& frame, cv::Mat& out) {
+    frame.frame.copyTo(out);
+
+    for (const auto& landmark : frame.landmarks) {
+        cv::circle(out, landmark, 4, cv::Scalar(0, 255, 0), -1);
+    }
+
+    if (frame.roi.empty() == false)
+        cv::rectangle(out, frame.roi, cv::Scalar(255, 128, 0), 1);
+
+    int y = 70;
+    for (const auto& line : frame.lines) {
+        cv::putText(out, line, cv::Point(20, y), cv::FONT_HERSHEY_PLAIN, 3, cv::Scalar(0, 196, 255), 2);
+        y += 50;
+    }
+}
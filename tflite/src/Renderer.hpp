@@ -0,0 +1,94 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "opencv2/core.hpp"
+
+#define RENDER_DISPLAY_FPS  30  // Max display rate, also the key polling rate
+
+namespace hand {
+
+    /*
+    What to display for one frame.
+    Attributes:
+        window: window name, one mailbox per window
+        frame: captured frame, never modified (the renderer draws on a copy)
+        landmarks: hand landmarks in frame coordinates
+        roi: optional box (e.g. tracked hand), empty to skip
+        lines: text lines drawn at the top left
+    */
+    struct RenderFrame {
+        std::string window = "Hand detector";
+        cv::Mat frame;
+        std::vector<cv::Point> landmarks;
+        cv::Rect roi;
+        std::vector<std::string> lines;
+    };
+
+    struct RendererStats {
+        size_t posted = 0;
+        size_t displayed = 0;
+        size_t replaced = 0;    // Posted frames overwritten before being displayed
+    };
+
+    /*
+    Draw and display results on a thread of its own, so imshow / waitKey
+    never run inside the inference loop.
+    post() only stores the frame in a mailbox which keeps the latest frame
+    per window: when the display is slower than inference, older frames are
+    replaced, never queued. The thread displays at most RENDER_DISPLAY_FPS.
+    A disabled renderer (headless) never starts a thread nor touches highgui,
+    post() is then a no-op.
+    This class is non-copyable.
+    */
+    class Renderer {
+        public:
+            Renderer(bool enabled = true);
+            Renderer(const Renderer& other) = delete;
+            Renderer& operator=(const Renderer& other) = delete;
+            ~Renderer();
+
+            bool isEnabled() const;
+
+            /*
+            Hand a frame to the render thread, replacing the one not yet displayed.
+            */
+            void post(RenderFrame frame);
+
+            /*
+            True once ESC has been pressed in a window.
+            */
+            bool isQuitRequested() const;
+
+            /*
+            Stop the render thread and close the windows.
+            */
+            void stop();
+
+            RendererStats getStats() const;
+
+        private:
+            void run();
+            static void draw(const RenderFrame& frame, cv::Mat& out);
+
+        private:
+            bool m_enabled;
+            std::thread m_thread;
+            std::atomic<bool> m_running;
+            std::atomic<bool> m_quit;
+
+            mutable std::mutex m_mutex;
+            std::condition_variable m_ready;
+            std::map<std::string, RenderFrame> m_mailbox;
+            RendererStats m_stats;
+    };
+}
+
+#endif // RENDERER_H
@@ -0,0 +1,172 @@
+#include "SkinTracker.hpp"
+
+#include <algorithm>
+
+/*
+Pixels too dark or too gray carry no reliable hue
+*/
+#define SKIN_MIN_SAT    30
+#define SKIN_MIN_VAL    40
+
+static const int   histSize[] = {SKIN_HUE_BINS, SKIN_SAT_BINS};
+static const float hueRange[] = {0, 180};
+static const float satRange[] = {0, 256};
+static const float* histRanges[] = {hueRange, satRange};
+static const int   histChannels[] = {0, 1};
+
+
+hand::SkinTracker::SkinTracker() :
+    m_hasModel(false), m_learnedArea(0.0), m_tracking(false)
+{}
+
+
+bool hand::SkinTracker::learn(const cv::Mat& frame, const std::vector<cv::Point>& landmarks, float confidence) {
+    if (landmarks.size() < 3) {
+        m_tracking = false;
+        return false;
+    }
+    if (confidence < SKIN_MIN_CONFIDENCE)
+        return false;
+
+    cv::Rect frameRect(0, 0, frame.cols, frame.rows);
+    cv::Rect box = cv::boundingRect(landmarks) & frameRect;
+    if (box.area() == 0)
+        return false;
+
+    /*
+    Only the bounding box of the hand is converted,
+    the convex hull of the landmarks selects the skin pixels inside it.
+    */
+    cv::Mat hsv;
+    toHsv(frame(box), hsv);
+
+    std::vector<cv::Point> hull;
+    cv::convexHull(landmarks, hull);
+    for (auto& pt : hull) {
+        pt -= box.tl();
+    }
+
+    cv::Mat mask(box.size(), CV_8UC1, cv::Scalar(0));
+    cv::fillConvexPoly(mask, hull, cv::Scalar(255));
+
+    cv::Mat valid;
+    cv::inRange(hsv, cv::Scalar(0, SKIN_MIN_SAT, SKIN_MIN_VAL), cv::Scalar(180, 256, 256), valid);
+    mask &= valid;
+
+    cv::Mat hist;
+    cv::calcHist(&hsv, 1, histChannels, mask, hist, 2, histSize, histRanges);
+    cv::normalize(hist, hist, 0, 255, cv::NORM_MINMAX);
+
+    if (m_hasModel)
+        cv::addWeighted(m_hist, 1.f - SKIN_LEARNING_RATE, hist, SKIN_LEARNING_RATE, 0, m_hist);
+    else
+        m_hist = hist;
+
+    m_hasModel = true;
+    m_window = box;
+    m_box = cv::RotatedRect(cv::Point2f(box.x + box.width * 0.5f, box.y + box.height * 0.5f),
+        cv::Size2f(box.width, box.height), 0.f);
+    m_learnedArea = box.area();
+    m_tracking = true;
+    return true;
+}
+
+
+bool hand::SkinTracker::track(const cv::Mat& frame) {
+    if (m_tracking == false)
+        return false;
+
+    /*
+    Search only around the last position
+    */
+    int mx = (int)(m_window.width * SKIN_SEARCH_MARGIN);
+    int my = (int)(m_window.height * SKIN_SEARCH_MARGIN);
+    cv::Rect search = cv::Rect(m_window.x - mx, m_window.y - my, m_window.width + 2 * mx, m_window.height + 2 * my)
+                    & cv::Rect(0, 0, frame.cols, frame.rows);
+    if (search.area() == 0) {
+        m_tracking = false;
+        return false;
+    }
+
+    toHsv(frame(search), m_hsv);
+    backProject(m_hsv, m_backProjection);
+
+    cv::Rect window = m_window - search.tl();
+    window &= cv::Rect(0, 0, search.width, search.height);
+    if (window.area() == 0) {
+        m_tracking = false;
+        return false;
+    }
+
+    cv::TermCriteria criteria(cv::TermCriteria::EPS | cv::TermCriteria::COUNT, 10, 1);
+    cv::RotatedRect box = cv::CamShift(m_backProjection, window, criteria);
+
+    /*
+    Track quality: enough skin under the window, plausible size
+    */
+    double density = window.area() > 0 ? cv::mean(m_backProjection(window))[0] / 255.0 : 0.0;
+    double scale = window.area() / std::max(m_learnedArea, 1.0);
+    if (density < SKIN_MIN_DENSITY || scale > SKIN_MAX_SCALE_CHANGE || scale < 1.0 / SKIN_MAX_SCALE_CHANGE) {
+        m_tracking = false;
+        return false;
+    }
+
+    m_window = window + search.tl();
+    m_box = cv::RotatedRect(box.center + cv::Point2f(search.tl()), box.size, box.angle);
+    return true;
+}
+
+
+bool hand::SkinTracker::isTracking() const {
+    return m_tracking;
+}
+
+
+cv::Rect hand::SkinTracker::getHandRoi() const {
+    if (m_tracking == false)
+        return cv::Rect();
+
+    auto center = (m_window.tl() + m_window.br()) / 2;
+    int side = (int)(std::max(m_window.width, m_window.height) * SKIN_ROI_SCALE);
+    return cv::Rect(center.x - side / 2, center.y - side / 2, side, side);
+}
+
+
+cv::RotatedRect hand::SkinTracker::getTrackBox() const {
+    return m_box;
+}
+
+
+cv::Mat hand::SkinTracker::getSkinMask(const cv::Mat& frame, int threshold) const {
+    if (m_hasModel == false)
+        return cv::Mat();
+
+    cv::Mat hsv, mask;
+    toHsv(frame, hsv);
+    backProject(hsv, mask);
+    cv::threshold(mask, mask, threshold, 255, cv::THRESH_BINARY);
+    return mask;
+}
+
+
+void hand::SkinTracker::reset() {
+    m_hist.release();
+    m_hasModel = false;
+    m_tracking = false;
+    m_learnedArea = 0.0;
+}
+
+//-------------------Private methods start here-------------------
+
+void hand::SkinTracker::toHsv(const cv::Mat& frame, cv::Mat& hsv) const {
+    cv::cvtColor(frame, hsv, cv::COLOR_BGR2HSV);
+}
+
+
+void hand::SkinTracker::backProject(const cv::Mat& hsv, cv::Mat& out) const {
+    cv::calcBackProject(&hsv, 1, histChannels, m_hist, out, histRanges);
+
+    cv::Mat valid;
+    cv::inRange(hsv, cv::Scalar(0, SKIN_MIN_SAT, SKIN_MIN_VAL), cv::Scalar(180, 256, 256), valid);
+    out &= valid;
+}
@@ -0,0 +1,96 @@
+#ifndef SKINTRACKER_H
+#define SKINTRACKER_H
+
+#include <vector>
+
+#include "opencv2/core.hpp"
+#include "opencv2/imgproc.hpp"
+#include "opencv2/video.hpp"
+
+#define SKIN_HUE_BINS           30
+#define SKIN_SAT_BINS           32
+#define SKIN_MIN_CONFIDENCE     0.8f  // Hand presence needed to learn from landmarks
+#define SKIN_LEARNING_RATE      0.3f  // Weight of a new histogram in the user model
+#define SKIN_MIN_DENSITY        0.25f // Mean back projection under the track, below it the track is lost
+#define SKIN_MAX_SCALE_CHANGE   3.f   // Max track area change relative to the learned hand
+#define SKIN_SEARCH_MARGIN      0.5f  // Search window = track window grown by this fraction per side
+#define SKIN_ROI_SCALE          1.5f  // Same framing as HandLandmark::getRoiFromLandmarks()
+
+namespace hand {
+
+    /*
+    A cheap hand tracker seeded by the neural pipeline.
+
+    When the landmarks are confident, learn() builds a hue-saturation histogram
+    from the pixels inside the hand (convex hull of the landmarks), blended into
+    a per-user skin model. track() then follows the hand with back projection
+    and CamShift inside a search window around the last position.
+    When the back projection under the track gets too sparse or the track
+    changes size too much, the track is dropped and the caller MUST fall back
+    to the palm detector.
+    */
+    class SkinTracker {
+        public:
+            SkinTracker();
+
+            /*
+            Learn the skin color of the user from a neural result on frame (BGR).
+            Nothing is learned below SKIN_MIN_CONFIDENCE, and the track stops
+            if the neural pipeline found no hand (empty landmarks).
+            Return true if the tracker has been (re)started from the landmarks.
+            */
+            bool learn(const cv::Mat& frame, const std::vector<cv::Point>& landmarks, float confidence);
+
+            /*
+            Follow the hand on frame (BGR). Return false if the track is lost.
+            */
+            bool track(const cv::Mat& frame);
+
+            /*
+            True if a skin model has been learned and the track is alive.
+            */
+            bool isTracking() const;
+
+            /*
+            Get a square roi around the tracked hand, to feed HandLandmark::runTracking().
+            */
+            cv::Rect getHandRoi() const;
+
+            /*
+            Get the last CamShift box.
+            */
+            cv::RotatedRect getTrackBox() const;
+
+            /*
+            Skin mask of frame (BGR) from the learned per-user model
+            (replacement for a fixed HSV range). Empty if nothing is learned yet.
+            */
+            cv::Mat getSkinMask(const cv::Mat& frame, int threshold = 64) const;
+
+            void reset();
+
+        private:
+            void toHsv(const cv::Mat& frame, cv::Mat& hsv) const;
+            void backProject(const cv::Mat& hsv, cv::Mat& out) const;
+
+        private:
+            /*
+            Per-user skin model (CV_32F, SKIN_HUE_BINS x SKIN_SAT_BINS, max 255)
+            */
+            cv::Mat m_hist;
+            bool m_hasModel;
+
+            cv::Rect m_window;
+            cv::RotatedRect m_box;
+            double m_learnedArea;
+            bool m_tracking;
+
+            /*
+            Buffers reused between frames
+            */
+            cv::Mat m_hsv;
+            cv::Mat m_backProjection;
+    };
+}
+
+#endif // SKINTRACKER_H
@@ -0,0 +1,66 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace hand {
+
+    /*
+    A lock-free single producer / single consumer ring of Capacity - 1 items.
+    push() is only called from one thread and pop() from one other thread,
+    neither ever blocks or allocates. Capacity MUST be a power of two.
+    */
+    template <typename T, size_t Capacity>
+    class SpscRing {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+        public:
+            SpscRing() : m_head(0), m_tail(0) {}
+            SpscRing(const SpscRing& other) = delete;
+            SpscRing& operator=(const SpscRing& other) = delete;
+
+            /*
+            Producer side. Return false (item not queued) if the ring is full.
+            */
+            bool push(const T& item) {
+                const size_t head = m_head.load(std::memory_order_relaxed);
+                const size_t next = (head + 1) & (Capacity - 1);
+                if (next == m_tail.load(std::memory_order_acquire))
+                    return false;
+
+                m_items[head] = item;
+                m_head.store(next, std::memory_order_release);
+                return true;
+            }
+
+            /*
+            Consumer side. Return false if the ring is empty.
+            */
+            bool pop(T& item) {
+                const size_t tail = m_tail.load(std::memory_order_relaxed);
+                if (tail == m_head.load(std::memory_order_acquire))
+                    return false;
+
+                item = m_items[tail];
+                m_tail.store((tail + 1) & (Capacity - 1), std::memory_order_release);
+                return true;
+            }
+
+            bool empty() const {
+                return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+            }
+
+        private:
+            /*
+            Head and tail on their own cache lines: the producer and the
+            consumer do not invalidate each other on every operation.
+            */
+            alignas(64) std::atomic<size_t> m_head;
+            alignas(64) std::atomic<size_t> m_tail;
+            alignas(64) std::array<T, Capacity> m_items;
+    };
+}
+
+#endif // SPSCRING_H
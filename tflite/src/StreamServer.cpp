@@ -0,0 +1,296 @@
+#include "StreamServer.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
+/*
+Helper function
+*/
+bool __isCameraIndex(const std::string& source) {
+    return !source.empty() && std::all_of(source.begin(), source.end(), ::isdigit);
+}
+
+
+hand::StreamServer::StreamServer(const std::string& modelDir, int numSessions) :
+    m_models(HandModels::load(modelDir)), m_running(false)
+{
+    if (numSessions <= 0)
+        numSessions = std::max(1u, std::thread::hardware_concurrency());
+
+    /*
+    The pool already runs one session per core,
+    so each interpreter gets a single thread.
+    */
+    m_pool = std::make_unique<InferencePool>(m_models, numSessions, 1);
+}
+
+
+hand::StreamServer::~StreamServer() {
+    stop();
+}
+
+
+int hand::StreamServer::addStream(const std::string& source, double deadlineMs) {
+    if (m_running) {
+        std::cerr << "Streams must be added before start()." << std::endl;
+        return -1;
+    }
+
+    auto stream = std::make_unique<Stream>();
+    stream->id = m_streams.size();
+    stream->source = source;
+    stream->isCamera = __isCameraIndex(source);
+    stream->open = false;
+
+    if (stream->isCamera)
+        stream->capture.open(std::stoi(source), cv::CAP_V4L2);
+    else
+        stream->capture.open(source);
+
+    if (stream->capture.isOpened() == false) {
+        std::cerr << "Fail to open stream: " << source << std::endl;
+        return -1;
+    }
+
+    stream->sourceFps = stream->capture.get(cv::CAP_PROP_FPS);
+    if (stream->sourceFps <= 0)
+        stream->sourceFps = 30.0;
+
+    stream->deadline = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(deadlineMs));
+    m_scheduler.addStream();
+
+    m_streams.push_back(std::move(stream));
+    return m_streams.back()->id;
+}
+
+
+void hand::StreamServer::enableBatchedDetection(int maxBatch, double windowMs) {
+    if (m_running) {
+        std::cerr << "Batched detection must be enabled before start()." << std::endl;
+        return;
+    }
+    if (maxBatch <= 0)
+        maxBatch = getNumberOfSessions();
+
+    m_batcher = std::make_unique<DetectionBatcher>(m_models.palm, maxBatch, windowMs);
+}
+
+
+hand::DetectionBatchStats hand::StreamServer::getBatchStats() const {
+    if (m_batcher == nullptr)
+        return DetectionBatchStats();
+
+    return m_batcher->getStats();
+}
+
+
+void hand::StreamServer::start() {
+    if (m_running)
+        return;
+
+    m_running = true;
+    m_startTime = Clock::now();
+    for (auto& stream : m_streams) {
+        stream->open = true;
+        stream->thread = std::thread(&StreamServer::captureLoop, this, std::ref(*stream));
+    }
+}
+
+
+void hand::StreamServer::stop() {
+    m_running = false;
+    for (auto& stream : m_streams) {
+        if (stream->thread.joinable())
+            stream->thread.join();
+        stream->capture.release();
+    }
+
+    /*
+    A running job may queue the next one: the pool is idle only once the scheduler is empty
+    */
+    m_pool->waitIdle();
+}
+
+
+bool hand::StreamServer::isRunning() const {
+    for (auto& stream : m_streams) {
+        if (stream->open)
+            return true;
+    }
+    return false;
+}
+
+
+int hand::StreamServer::getNumberOfStreams() const {
+    return m_streams.size();
+}
+
+
+int hand::StreamServer::getNumberOfSessions() const {
+    return m_pool->getNumberOfSessions();
+}
+
+
+std::string hand::StreamServer::getSourceName(int id) const {
+    if (isIdValid(id))
+        return m_streams[id]->source;
+
+    return std::string();
+}
+
+
+bool hand::StreamServer::getLatestResult(int id, StreamResult& out) {
+    if (isIdValid(id) == false)
+        return false;
+
+    Stream& stream = *m_streams[id];
+    std::lock_guard<std::mutex> lock(stream.mutex);
+    if (stream.hasNewResult == false)
+        return false;
+
+    out = stream.result;
+    stream.hasNewResult = false;
+    return true;
+}
+
+
+hand::StreamStats hand::StreamServer::getStats(int id) const {
+    if (isIdValid(id) == false)
+        return StreamStats();
+
+    const Stream& stream = *m_streams[id];
+    std::lock_guard<std::mutex> lock(stream.mutex);
+    StreamStats stats = stream.stats;
+
+    auto schedulerStats = m_scheduler.getStats(id);
+    stats.dropped = schedulerStats.dropped;
+    stats.skipped = schedulerStats.skipped;
+    stats.late = schedulerStats.late;
+    stats.tracked = schedulerStats.tracked;
+
+    auto gateStats = stream.gate.getStats();
+    stats.gated = gateStats.skipped;
+    stats.savedMs = gateStats.savedMs;
+
+    double elapsed = std::chrono::duration<double>(Clock::now() - m_startTime).count();
+    if (elapsed > 0)
+        stats.fps = stats.processed / elapsed;
+    return stats;
+}
+
+//-------------------Private methods start here-------------------
+
+void hand::StreamServer::captureLoop(Stream& stream) {
+    auto frameInterval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / stream.sourceFps));
+    auto nextFrameTime = Clock::now();
+    size_t frameIndex = 0;
+
+    while (m_running) {
+        cv::Mat frame;
+        if (stream.capture.read(frame) == false || frame.empty())
+            break;
+
+        auto captureTime = Clock::now();
+        if (stream.isCamera)
+            cv::flip(frame, frame, 1);
+
+        {
+            std::lock_guard<std::mutex> lock(stream.mutex);
+            stream.stats.captured++;
+        }
+
+        /*
+        Static scenes never reach the scheduler.
+        */
+        if (stream.gate.shouldRun(frame)) {
+            FrameJob job;
+            job.streamId = stream.id;
+            job.frameIndex = frameIndex;
+            job.frame = frame;
+            job.captureTime = captureTime;
+            job.deadline = captureTime + stream.deadline;
+            m_scheduler.push(std::move(job));
+            m_pool->submit([this](HandLandmark& session) { runNextJob(session); });
+        }
+        frameIndex++;
+
+        /*
+        Cameras block in read(), video files are paced to their own frame rate.
+        */
+        if (stream.isCamera == false) {
+            nextFrameTime += frameInterval;
+            std::this_thread::sleep_until(nextFrameTime);
+        }
+    }
+    stream.open = false;
+}
+
+
+void hand::StreamServer::runNextJob(HandLandmark& session) {
+    FrameJob job;
+    if (m_scheduler.pop(job) == false)
+        return;
+
+    auto start = Clock::now();
+    if (job.kind == JobKind::Track) {
+        session.runTracking(job.frame, job.trackRoi);
+    }
+    else if (m_batcher != nullptr) {
+        /*
+        Palm detection batched with the other streams, landmarks on this session
+        */
+        session.runTracking(job.frame, m_batcher->detect(job.frame));
+    }
+    else {
+        session.loadImageToInput(job.frame);
+        session.runInference();
+    }
+    double inferenceMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    onProcessed(job, inferenceMs, session);
+    m_scheduler.complete(job, inferenceMs, session.getRoiFromLandmarks());
+
+    /*
+    Frames of this stream may have been queued while it was busy:
+    one task per push() is not enough to run them.
+    */
+    if (m_scheduler.hasRunnable())
+        m_pool->submit([this](HandLandmark& session) { runNextJob(session); });
+}
+
+
+void hand::StreamServer::onProcessed(const FrameJob& job, double inferenceMs, HandLandmark& session) {
+    auto landmarks = session.getAllHandLandmarks();
+    auto roi = session.getHandRoi();
+    double latencyMs = std::chrono::duration<double, std::milli>(Clock::now() - job.captureTime).count();
+
+    Stream& stream = *m_streams[job.streamId];
+    stream.gate.setHandPresent(landmarks.empty() == false);
+    stream.gate.reportInference(inferenceMs);
+
+    std::lock_guard<std::mutex> lock(stream.mutex);
+    stream.result.frame = job.frame;
+    stream.result.roi = roi;
+    stream.result.landmarks = std::move(landmarks);
+    stream.result.frameIndex = job.frameIndex;
+    stream.hasNewResult = true;
+
+    stream.stats.processed++;
+    stream.latencySumMs += latencyMs;
+    stream.inferenceSumMs += inferenceMs;
+    stream.stats.avgLatencyMs = stream.latencySumMs / stream.stats.processed;
+    stream.stats.avgInferenceMs = stream.inferenceSumMs / stream.stats.processed;
+}
+
+
+bool hand::StreamServer::isIdValid(int id) const {
+    if (id < 0 || id >= (int)m_streams.size()) {
+        std::cerr << "Stream " << id << " is out of range (" \
+        << m_streams.size() << ")." << std::endl;
+        return false;
+    }
+    return true;
+}
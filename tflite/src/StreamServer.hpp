@@ -0,0 +1,187 @@
+#ifndef STREAMSERVER_H
+#define STREAMSERVER_H
+
+#include "InferencePool.hpp"
+#include "DetectionBatcher.hpp"
+#include "FrameScheduler.hpp"
+#include "MotionGate.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "opencv2/videoio.hpp"
+
+#define DEFAULT_STREAM_DEADLINE_MS 100.0
+
+namespace hand {
+
+    /*
+    Counters of a single stream.
+    Attributes:
+        captured: frames read from the source
+        processed: frames which went through inference
+        dropped: frames replaced by a newer one before a session was free
+        skipped: frames not run because they would have missed their deadline
+        late: frames whose result came after their deadline
+        tracked: frames processed by landmark tracking only (no palm detection)
+        gated: frames not queued because the MotionGate saw no motion
+        savedMs: inference time saved by the MotionGate
+        avgLatencyMs: mean time from capture to result
+        avgInferenceMs: mean time spent inside the session
+        fps: processed frames per second since start()
+    */
+    struct StreamStats {
+        size_t captured = 0;
+        size_t processed = 0;
+        size_t dropped = 0;
+        size_t skipped = 0;
+        size_t late = 0;
+        size_t tracked = 0;
+        size_t gated = 0;
+        double savedMs = 0.0;
+        double avgLatencyMs = 0.0;
+        double avgInferenceMs = 0.0;
+        double fps = 0.0;
+    };
+
+    /*
+    Last result of a stream.
+    Sessions are shared, so nothing stream specific is kept inside them:
+    the roi tracked from one frame to the next lives in the FrameScheduler.
+    */
+    struct StreamResult {
+        cv::Mat frame;
+        cv::Rect roi;
+        std::vector<cv::Point> landmarks;
+        size_t frameIndex = 0;
+    };
+
+    /*
+    Serve several camera or video file streams from one process.
+    Every stream has its own capture thread and result, while all of them
+    share the loaded models and one InferencePool.
+
+    Frames go through a FrameScheduler: a stream has at most one frame in
+    flight, stale frames are skipped before inference, and streams which
+    track a hand (landmark model only) go ahead of streams which need palm
+    detection. A fast source can never starve a slow one.
+    A per-stream MotionGate keeps static scenes away from the scheduler.
+    This class is non-copyable.
+    */
+    class StreamServer {
+        public:
+            /*
+            Parameters:
+                modelDir: FOLDER contain the models
+                numSessions: number of inference sessions (0: one per hardware thread)
+            */
+            StreamServer(const std::string& modelDir, int numSessions = 0);
+            StreamServer(const StreamServer& other) = delete;
+            StreamServer& operator=(const StreamServer& other) = delete;
+            ~StreamServer();
+
+            /*
+            Open a source before start().
+            A source made only of digits is a camera index (/dev/videoN),
+            anything else is a video file, played at its own frame rate.
+            Each frame must be processed within deadlineMs of its capture.
+            Return the stream id, or -1 if the source cannot be opened.
+            */
+            int addStream(const std::string& source, double deadlineMs = DEFAULT_STREAM_DEADLINE_MS);
+
+            /*
+            Run the palm detection of all streams through one DetectionBatcher
+            (before start()): sessions wait at most windowMs to share an invoke.
+            maxBatch = 0 uses the number of sessions.
+            */
+            void enableBatchedDetection(int maxBatch = 0, double windowMs = BATCH_DEFAULT_WINDOW_MS);
+
+            /*
+            Counters of the batched detection (all zero if it is not enabled).
+            */
+            DetectionBatchStats getBatchStats() const;
+
+            /*
+            Start capturing on every stream.
+            */
+            void start();
+
+            /*
+            Stop capturing, then wait until every queued frame has been run
+            or skipped: getStats() is final after this returns.
+            */
+            void stop();
+
+            /*
+            True while at least one stream still delivers frames.
+            */
+            bool isRunning() const;
+
+            int getNumberOfStreams() const;
+
+            int getNumberOfSessions() const;
+
+            std::string getSourceName(int id) const;
+
+            /*
+            Copy the latest result of stream id to out.
+            Return false if nothing new has been produced since the last call.
+            */
+            bool getLatestResult(int id, StreamResult& out);
+
+            StreamStats getStats(int id) const;
+
+        private:
+            struct Stream {
+                int id;
+                std::string source;
+                bool isCamera;
+                double sourceFps;
+                Clock::duration deadline;
+                cv::VideoCapture capture;
+                std::thread thread;
+                std::atomic<bool> open;
+                MotionGate gate;
+
+                mutable std::mutex mutex;
+                StreamResult result;
+                bool hasNewResult = false;
+
+                StreamStats stats;
+                double latencySumMs = 0.0;
+                double inferenceSumMs = 0.0;
+            };
+
+            void captureLoop(Stream& stream);
+
+            /*
+            Pool task: run the most urgent job of the scheduler on session.
+            */
+            void runNextJob(HandLandmark& session);
+
+            void onProcessed(const FrameJob& job, double inferenceMs, HandLandmark& session);
+
+            bool isIdValid(int id) const;
+
+        private:
+            /*
+            Streams (and the batcher) are declared before the pool: the pool is
+            destroyed (and drains its tasks) while they are still alive.
+            */
+            std::vector<std::unique_ptr<Stream>> m_streams;
+            FrameScheduler m_scheduler;
+            HandModels m_models;
+            std::unique_ptr<DetectionBatcher> m_batcher;
+            std::unique_ptr<InferencePool> m_pool;
+
+            std::atomic<bool> m_running;
+            Clock::time_point m_startTime;
+    };
+}
+
+#endif // STREAMSERVER_H
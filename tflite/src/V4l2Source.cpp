@@ -0,0 +1,237 @@
+#include "V4l2Source.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <linux/videodev2.h>
+
+
+/*
+Helper function
+*/
+static unsigned int __toFourcc(hand::PixelFormat format) {
+    return format == hand::PixelFormat::NV12 ? V4L2_PIX_FMT_NV12 : V4L2_PIX_FMT_YUYV;
+}
+
+
+hand::V4l2Source::V4l2Source(const std::string& device, cv::Size size, PixelFormat format, bool mirror) :
+    m_fd(-1), m_streaming(false), m_mirror(mirror), m_format(format), m_size(size), m_stride(0), m_held(-1)
+{
+    if (open(device, size, format) == false)
+        release();
+}
+
+
+hand::V4l2Source::~V4l2Source() {
+    release();
+}
+
+
+bool hand::V4l2Source::isOpened() const {
+    return m_streaming;
+}
+
+
+bool hand::V4l2Source::read(Frame& frame) {
+    if (m_streaming == false)
+        return false;
+
+    requeueHeld();
+
+    pollfd fds = { m_fd, POLLIN, 0 };
+    int ready = poll(&fds, 1, V4L2_TIMEOUT_MS);
+    if (ready <= 0) {
+        std::cerr << "V4L2: no frame within " << V4L2_TIMEOUT_MS << "ms" << std::endl;
+        return false;
+    }
+
+    v4l2_buffer buffer;
+    std::memset(&buffer, 0, sizeof(buffer));
+    buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buffer.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(VIDIOC_DQBUF, &buffer) == -1) {
+        std::cerr << "V4L2: VIDIOC_DQBUF failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    m_held = buffer.index;
+
+    /*
+    Header on the mmap buffer, valid until the next read()
+    */
+    void* data = m_buffers[buffer.index].start;
+    if (m_format == PixelFormat::NV12)
+        frame.data = cv::Mat(m_size.height * 3 / 2, m_size.width, CV_8UC1, data, m_stride);
+    else
+        frame.data = cv::Mat(m_size, CV_8UC2, data, m_stride);
+
+    frame.format = m_format;
+    frame.mirrored = m_mirror;
+    frame.sequence = buffer.sequence;
+    frame.timeMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return true;
+}
+
+
+void hand::V4l2Source::release() {
+    if (m_fd == -1)
+        return;
+
+    if (m_streaming) {
+        v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        xioctl(VIDIOC_STREAMOFF, &type);
+        m_streaming = false;
+    }
+    for (auto& buffer : m_buffers) {
+        munmap(buffer.start, buffer.length);
+    }
+    m_buffers.clear();
+    m_held = -1;
+
+    close(m_fd);
+    m_fd = -1;
+}
+
+
+hand::PixelFormat hand::V4l2Source::getFormat() const {
+    return m_format;
+}
+
+
+cv::Size hand::V4l2Source::getSize() const {
+    return m_size;
+}
+
+//-------------------Private methods start here-------------------
+
+bool hand::V4l2Source::open(const std::string& device, cv::Size size, PixelFormat format) {
+    m_fd = ::open(device.c_str(), O_RDWR | O_NONBLOCK);
+    if (m_fd == -1) {
+        std::cerr << "V4L2: cannot open " << device << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    v4l2_capability capability;
+    if (xioctl(VIDIOC_QUERYCAP, &capability) == -1
+     || (capability.capabilities & V4L2_CAP_VIDEO_CAPTURE) == 0
+     || (capability.capabilities & V4L2_CAP_STREAMING) == 0) {
+        std::cerr << "V4L2: " << device << " is not a streaming capture device" << std::endl;
+        return false;
+    }
+
+    /*
+    Try the requested format first, then the other YUV one.
+    */
+    PixelFormat other = format == PixelFormat::NV12 ? PixelFormat::YUYV : PixelFormat::NV12;
+    if (setFormat(size, format) == false && setFormat(size, other) == false) {
+        std::cerr << "V4L2: " << device << " supports neither YUYV nor NV12" << std::endl;
+        return false;
+    }
+
+    if (mapBuffers() == false)
+        return false;
+
+    for (size_t i = 0; i < m_buffers.size(); ++i) {
+        v4l2_buffer buffer;
+        std::memset(&buffer, 0, sizeof(buffer));
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_MMAP;
+        buffer.index = i;
+        if (xioctl(VIDIOC_QBUF, &buffer) == -1) {
+            std::cerr << "V4L2: VIDIOC_QBUF failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    }
+
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(VIDIOC_STREAMON, &type) == -1) {
+        std::cerr << "V4L2: VIDIOC_STREAMON failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    m_streaming = true;
+    return true;
+}
+
+
+bool hand::V4l2Source::setFormat(cv::Size size, PixelFormat format) {
+    v4l2_format fmt;
+    std::memset(&fmt, 0, sizeof(fmt));
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = size.width;
+    fmt.fmt.pix.height = size.height;
+    fmt.fmt.pix.pixelformat = __toFourcc(format);
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+
+    if (xioctl(VIDIOC_S_FMT, &fmt) == -1 || fmt.fmt.pix.pixelformat != __toFourcc(format))
+        return false;
+
+    m_format = format;
+    m_size = cv::Size(fmt.fmt.pix.width, fmt.fmt.pix.height);
+    m_stride = fmt.fmt.pix.bytesperline;
+    return true;
+}
+
+
+bool hand::V4l2Source::mapBuffers() {
+    v4l2_requestbuffers request;
+    std::memset(&request, 0, sizeof(request));
+    request.count = V4L2_NUM_BUFFERS;
+    request.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    request.memory = V4L2_MEMORY_MMAP;
+
+    if (xioctl(VIDIOC_REQBUFS, &request) == -1 || request.count < 2) {
+        std::cerr << "V4L2: cannot get mmap buffers" << std::endl;
+        return false;
+    }
+
+    for (unsigned int i = 0; i < request.count; ++i) {
+        v4l2_buffer buffer;
+        std::memset(&buffer, 0, sizeof(buffer));
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_MMAP;
+        buffer.index = i;
+        if (xioctl(VIDIOC_QUERYBUF, &buffer) == -1) {
+            std::cerr << "V4L2: VIDIOC_QUERYBUF failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        void* start = mmap(nullptr, buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, buffer.m.offset);
+        if (start == MAP_FAILED) {
+            std::cerr << "V4L2: mmap failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        m_buffers.push_back({ start, buffer.length });
+    }
+    return true;
+}
+
+
+void hand::V4l2Source::requeueHeld() {
+    if (m_held == -1)
+        return;
+
+    v4l2_buffer buffer;
+    std::memset(&buffer, 0, sizeof(buffer));
+    buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buffer.memory = V4L2_MEMORY_MMAP;
+    buffer.index = m_held;
+    if (xioctl(VIDIOC_QBUF, &buffer) == -1)
+        std::cerr << "V4L2: VIDIOC_QBUF failed: " << std::strerror(errno) << std::endl;
+    m_held = -1;
+}
+
+
+int hand::V4l2Source::xioctl(unsigned long request, void* arg) const {
+    int result;
+    do {
+        result = ioctl(m_fd, request, arg);
+    } while (result == -1 && errno == EINTR);
+    return result;
+}
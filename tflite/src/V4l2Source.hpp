@@ -0,0 +1,78 @@
+#ifndef V4L2SOURCE_H
+#define V4L2SOURCE_H
+
+#include "FrameSource.hpp"
+
+#include <vector>
+
+#define V4L2_NUM_BUFFERS    4       // Driver buffers: one held by the app, the rest being filled
+#define V4L2_TIMEOUT_MS     2000    // read() gives up when no frame comes within this time
+
+namespace hand {
+
+    /*
+    Capture straight from a V4L2 device with mmap buffers.
+    read() dequeues a filled buffer and returns a Frame pointing into it
+    (no copy, no BGR decode): the previous buffer goes back to the driver
+    at the next read(), so one buffer is held by the application at a time.
+    Frames stay YUYV or NV12 and are converted directly to model inputs
+    (see frameToTensor()).
+    Works with any V4L2 camera, or with the vivid test driver
+    (modprobe vivid) when there is no camera.
+    This class is non-copyable.
+    */
+    class V4l2Source : public FrameSource {
+        public:
+            /*
+            Parameters:
+                device: e.g. /dev/video0
+                size: requested size (the driver may pick the closest one)
+                format: YUYV or NV12, falls back to the other one if not supported
+                mirror: deliver frames mirrored (selfie view)
+            */
+            V4l2Source(const std::string& device = "/dev/video0", cv::Size size = cv::Size(640, 480),
+                       PixelFormat format = PixelFormat::YUYV, bool mirror = true);
+            V4l2Source(const V4l2Source& other) = delete;
+            V4l2Source& operator=(const V4l2Source& other) = delete;
+            virtual ~V4l2Source();
+
+            virtual bool isOpened() const;
+            virtual bool read(Frame& frame);
+            virtual void release();
+
+            /*
+            Format and size negotiated with the driver.
+            */
+            PixelFormat getFormat() const;
+            cv::Size getSize() const;
+
+        private:
+            bool open(const std::string& device, cv::Size size, PixelFormat format);
+            bool setFormat(cv::Size size, PixelFormat format);
+            bool mapBuffers();
+
+            /*
+            Give the held buffer back to the driver.
+            */
+            void requeueHeld();
+
+            int xioctl(unsigned long request, void* arg) const;
+
+        private:
+            struct Buffer {
+                void* start;
+                size_t length;
+            };
+
+            int m_fd;
+            bool m_streaming;
+            bool m_mirror;
+            PixelFormat m_format;
+            cv::Size m_size;
+            size_t m_stride;
+            std::vector<Buffer> m_buffers;
+            int m_held;     // Index of the buffer returned by the last read(), -1 if none
+    };
+}
+
+#endif // V4L2SOURCE_H
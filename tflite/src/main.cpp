@@ -1,21 +1,217 @@
 //#include "IrisLandmark.hpp"
 #include "Handlandmark.hpp" 
+#include "StreamServer.hpp"
+#include "MotionGate.hpp"
+#include "LandmarkFlow.hpp"
+#include "SkinTracker.hpp"
+#include "GestureEngine.hpp"
+#include "Renderer.hpp"
+#include "V4l2Source.hpp"
+#ifdef WITH_GSTREAMER
+    #include "GstSource.hpp"
+#endif
 
+#include <chrono>
 #include <iostream>
+#include <thread>
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
 
 #define SHOW_FPS    (1)
+#define MOTION_GATE (1)
+
+/*
+Run the network on one frame out of FLOW_NEURAL_INTERVAL and
+carry the landmarks with optical flow on the frames in between.
+*/
+#define FLOW_INTERPOLATION      (1)
+#define FLOW_NEURAL_INTERVAL    (3)
+
+/*
+Follow the hand with a skin histogram learned from the landmarks (CamShift),
+so the landmark model can run on the tracked roi without palm detection.
+*/
+#define SKIN_TRACKING           (1)
+
+/*
+Recognize swipes, pinches, stop and finger counts from the landmark
+trajectories, on a separate thread fed through a lock-free ring.
+*/
+#define GESTURE_ENGINE          (1)
+#define GESTURE_DISPLAY_FRAMES  (30)
+
+/*
+Draw and display the results on a render thread, out of the timed loop.
+Set HEADLESS to run without any window (no highgui call at all).
+*/
+#define HEADLESS                (0)
 
-#if SHOW_FPS
-    #include <chrono>
+/*
+Capture YUYV / NV12 buffers straight from V4L2 (mmap, no copy) and convert
+them directly to the model inputs, instead of cv::VideoCapture's BGR frames.
+A BGR image is only made when something needs it (display, trackers).
+*/
+#define V4L2_CAPTURE            (0)
+#define V4L2_DEVICE             "/dev/video0"
+
+/*
+Replay raw frames recorded back to back (see RawFileSource), through the
+same raw path as V4L2_CAPTURE, e.g. from
+v4l2-ctl --set-fmt-video=width=640,height=480,pixelformat=YUYV --stream-mmap --stream-to=hand.yuyv
+*/
+#define RAW_FILE_CAPTURE        (0)
+#define RAW_FILE_PATH           "hand.yuyv"
+#define RAW_FILE_FORMAT         hand::PixelFormat::YUYV
+#define RAW_FILE_WIDTH          (640)
+#define RAW_FILE_HEIGHT         (480)
+
+/*
+Capture through a GStreamer pipeline ending in "appsink name=sink"
+(libcamera on the Pi, videotestsrc / filesrc for tests), zero-copy like V4L2.
+Needs cmake -DWITH_GSTREAMER=ON.
+*/
+#define GST_CAPTURE             (0)
+#define GST_PIPELINE            GST_DEFAULT_PIPELINE
+
+#if GST_CAPTURE && !defined(WITH_GSTREAMER)
+    #error "GST_CAPTURE needs the GStreamer frame source (cmake -DWITH_GSTREAMER=ON)"
 #endif
 
+#define RAW_CAPTURE             (V4L2_CAPTURE || GST_CAPTURE || RAW_FILE_CAPTURE)
+
+/*
+Run palm detection on overlapping tiles (one batched invoke) so that
+small / far hands are found on high resolution frames. Once a hand is
+found, only the tiles around it (and the full frame) are run.
+*/
+#define TILED_DETECTION         (0)
+#define TILE_COLS               (3)
+#define TILE_ROWS               (2)
+
+/*
+Stream server: run the palm detection of all streams in shared batched invokes.
+*/
+#define BATCHED_DETECTION       (1)
+
+/*
+Palm and landmark interpreters take turns with one tensor arena (lower peak RSS,
+one arena allocation per inference).
+*/
+#define SHARED_ARENA            (0)
+
+
+/*
+Load the camera input (BGR image or raw frame) to the palm detector.
+*/
+static void loadInput(hand::HandLandmark& landmarker, const cv::Mat& image) {
+    landmarker.loadImageToInput(image);
+}
+
+static void loadInput(hand::HandLandmark& landmarker, const hand::Frame& frame) {
+    landmarker.loadFrameToInput(frame);
+}
+
+
+/*
+Memory planned for each interpreter and for both, in KB.
+*/
+static void printMemoryInfo(const hand::HandLandmark& landmarker) {
+    auto print = [](const char* name, const hand::ModelMemory& memory) {
+        std::cout << name << ": arena " << memory.arenaBytes / 1024 << "KB"
+                  << ", persistent " << memory.persistentBytes / 1024 << "KB"
+                  << ", weights " << memory.weightBytes / 1024 << "KB";
+        if (memory.reservedBytes != memory.arenaBytes + memory.persistentBytes)
+            std::cout << ", reserved " << memory.reservedBytes / 1024 << "KB";
+        std::cout << std::endl;
+    };
+    print("Palm detection", landmarker.getPalmMemoryInfo());
+    print("Hand landmark", landmarker.getLandmarkMemoryInfo());
+    print(landmarker.isSharedArena() ? "Total (shared arena)" : "Total", landmarker.getMemoryInfo());
+}
+
+
+/*
+Serve every source given on the command line (camera index or video file)
+from one process: shared models, one pool of inference sessions.
+*/
+int runStreamServer(int argc, char* argv[]) {
+    hand::StreamServer server("./models");
+    for (int i = 1; i < argc; ++i) {
+        if (server.addStream(argv[i]) == -1)
+            return -1;
+    }
+    #if BATCHED_DETECTION
+        if (server.getNumberOfStreams() > 1)
+            server.enableBatchedDetection();
+    #endif
+    std::cout << server.getNumberOfStreams() << " streams, " 
+              << server.getNumberOfSessions() << " inference sessions" << std::endl;
+
+    hand::Renderer renderer(!HEADLESS);
+    server.start();
+    hand::StreamResult result;
+    while (server.isRunning() && renderer.isQuitRequested() == false) {
+        bool updated = false;
+        for (int id = 0; id < server.getNumberOfStreams(); ++id) {
+            if (server.getLatestResult(id, result) == false)
+                continue;
+
+            hand::RenderFrame render;
+            render.window = "Stream " + std::to_string(id);
+            render.frame = result.frame;
+            render.landmarks = result.landmarks;
+            renderer.post(std::move(render));
+            updated = true;
+        }
+
+        if (updated == false)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    server.stop();
+    renderer.stop();
+
+    for (int id = 0; id < server.getNumberOfStreams(); ++id) {
+        auto stats = server.getStats(id);
+        std::cout << "[" << server.getSourceName(id) << "] "
+                  << "captured: " << stats.captured
+                  << ", processed: " << stats.processed
+                  << ", dropped: " << stats.dropped
+                  << ", deadline misses: " << stats.skipped + stats.late
+                  << " (skipped " << stats.skipped << ", late " << stats.late << ")"
+                  << ", tracked: " << stats.tracked
+                  << ", gated: " << stats.gated
+                  << " (saved " << stats.savedMs / 1e3 << "s)"
+                  << ", fps: " << stats.fps
+                  << ", latency: " << stats.avgLatencyMs << "ms"
+                  << ", inference: " << stats.avgInferenceMs << "ms" << std::endl;
+    }
+
+    auto batchStats = server.getBatchStats();
+    if (batchStats.batches > 0) {
+        std::cout << "Batched detection: " << batchStats.requests << " frames in " << batchStats.batches << " invokes"
+                  << " (avg batch " << batchStats.avgBatchSize << ", padded " << batchStats.padded << ")"
+                  << ", wait: " << batchStats.avgWaitMs << "ms"
+                  << ", batch: " << batchStats.avgInvokeMs << "ms" << std::endl;
+    }
+    return 0;
+}
+
 
 int main(int argc, char* argv[]) {
 
-    hand::HandLandmark Landmarker("./models");
-    cv::VideoCapture cap(0, cv::CAP_V4L2); // /dev/video0 카메라 장치 열기
+    if (argc > 1)
+        return runStreamServer(argc, argv);
+
+    hand::HandLandmark Landmarker("./models"); // Handmap_micro: 고정 arena, 추론 중 힙 할당 없음
+    #if GST_CAPTURE
+        hand::GstSource cap(GST_PIPELINE); // appsink 버퍼를 복사 없이 사용
+    #elif V4L2_CAPTURE
+        hand::V4l2Source cap(V4L2_DEVICE); // 거울 모드 YUYV 캡처 (BGR 변환 없음)
+    #elif RAW_FILE_CAPTURE
+        hand::RawFileSource cap(RAW_FILE_PATH, RAW_FILE_FORMAT, cv::Size(RAW_FILE_WIDTH, RAW_FILE_HEIGHT)); // 녹화된 raw 프레임 재생
+    #else
+        cv::VideoCapture cap(0, cv::CAP_V4L2); // /dev/video0 카메라 장치 열기
+    #endif
     
     bool success = cap.isOpened();
     if(success == false){
@@ -23,31 +219,148 @@ int main(int argc, char* argv[]) {
         return -1;
     }
 
+    #if SHARED_ARENA
+        Landmarker.setSharedArena(true); // 손바닥/랜드마크 모델이 arena 하나를 번갈아 사용
+    #endif
+    printMemoryInfo(Landmarker);
+
+    #if TILED_DETECTION
+        hand::TileOptions tileOptions;
+        tileOptions.enabled = true;
+        tileOptions.cols = TILE_COLS;
+        tileOptions.rows = TILE_ROWS;
+        Landmarker.setTileOptions(tileOptions);
+    #endif
+
     #if SHOW_FPS
         float sum = 0;
         int count = 0;
     #endif
 
-    while (success)
+    #if MOTION_GATE
+        hand::MotionGate gate;
+    #endif
+
+    #if FLOW_INTERPOLATION
+        hand::LandmarkFlow flow;
+        int framesSinceInference = 0;
+    #endif
+
+    #if SKIN_TRACKING
+        hand::SkinTracker skinTracker;
+    #endif
+
+    #if GESTURE_ENGINE
+        hand::GestureEngine gestures;
+        gestures.start();
+        std::string gestureText;
+        int gestureDisplay = 0;
+    #endif
+
+    hand::Renderer renderer(!HEADLESS);
+
+    #if RAW_CAPTURE
+        const bool needImage = renderer.isEnabled() || SKIN_TRACKING || FLOW_INTERPOLATION || MOTION_GATE;
+    #endif
+
+    std::vector<cv::Point> landmarks;
+    while (success && renderer.isQuitRequested() == false)
     {
         cv::Mat rframe;
-        success = cap.read(rframe); // read a new frame from video
+        #if RAW_CAPTURE
+            hand::Frame frame;
+            success = cap.read(frame);
+
+            if (success == false)
+                break;
 
-        if (success == false)
-            break;
-        
-        cv::flip(rframe, rframe, 1);
+            // 모델 입력은 YUV 버퍼에서 직접 변환, BGR은 필요할 때만
+            if (needImage)
+                hand::FrameSource::toBGR(frame, rframe);
+            const hand::Frame& input = frame;
+        #else
+            success = cap.read(rframe); // read a new frame from video
+
+            if (success == false)
+                break;
+            
+            cv::flip(rframe, rframe, 1);
+            const cv::Mat& input = rframe;
+        #endif
 
         #if SHOW_FPS
             auto start = std::chrono::high_resolution_clock::now();
         #endif
 
-        Landmarker.loadImageToInput(rframe); // 프레임 입력 텐서로 변환
-        Landmarker.runInference(); // 모델 추론 실행
-        
-        for (auto landmark : Landmarker.getAllHandLandmarks()) {
-            cv::circle(rframe, landmark, 4, cv::Scalar(0, 255, 0), -1);
+        #if SKIN_TRACKING
+            skinTracker.track(rframe);
+        #endif
+
+        bool propagated = false;
+        #if FLOW_INTERPOLATION
+            // 추론 사이의 프레임은 optical flow로 랜드마크 이동 (실패 시 재추론)
+            if (++framesSinceInference < FLOW_NEURAL_INTERVAL)
+                propagated = flow.propagate(rframe, landmarks);
+        #endif
+
+        #if MOTION_GATE
+            bool runInference = !propagated && gate.shouldRun(rframe); // 움직임이 없으면 추론 생략
+        #else
+            bool runInference = !propagated;
+        #endif
+
+        if (runInference) {
+            auto inferenceStart = std::chrono::steady_clock::now();
+            #if TILED_DETECTION
+                // 손이 있던 주변 타일만 검사 (전체 프레임 타일은 항상 실행)
+                Landmarker.setRoiHint(landmarks.empty() ? cv::Rect() : cv::boundingRect(landmarks));
+            #endif
+            #if SKIN_TRACKING
+                // 추적 중이면 손바닥 검출 없이 랜드마크 모델만 실행
+                if (skinTracker.isTracking())
+                    Landmarker.runTracking(input, skinTracker.getHandRoi());
+                if (skinTracker.isTracking() == false || Landmarker.getHandRoi().empty()) {
+                    loadInput(Landmarker, input);
+                    Landmarker.runInference();
+                }
+            #else
+                loadInput(Landmarker, input); // 프레임 입력 텐서로 변환
+                Landmarker.runInference(); // 모델 추론 실행
+            #endif
+            landmarks = Landmarker.getAllHandLandmarks();
+
+            #if SKIN_TRACKING
+                skinTracker.learn(rframe, landmarks, Landmarker.getHandPresence());
+            #endif
+
+            #if MOTION_GATE
+                gate.setHandPresent(landmarks.empty() == false);
+                gate.reportInference(std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - inferenceStart).count());
+            #endif
+
+            #if FLOW_INTERPOLATION
+                flow.reset(rframe, landmarks);
+                framesSinceInference = 0;
+            #endif
+        }
+        else if (propagated == false) {
+            landmarks.clear();
         }
+
+        #if GESTURE_ENGINE
+            // 제스처 판정은 별도 스레드에서 (랜드마크만 복사해서 전달)
+            gestures.submit(landmarks, runInference ? Landmarker.getHandPresence() : 1.f);
+
+            hand::GestureEvent event;
+            while (gestures.pollEvent(event)) {
+                gestureText = hand::GestureEngine::toString(event.type);
+                if (event.type == hand::GestureType::FingerCount)
+                    gestureText += " " + std::to_string(event.fingers);
+                gestureDisplay = GESTURE_DISPLAY_FRAMES;
+                std::cout << gestureText << std::endl;
+            }
+        #endif
             
         #if SHOW_FPS
             auto stop = std::chrono::high_resolution_clock::now();
@@ -56,21 +369,70 @@ int main(int argc, char* argv[]) {
             sum += inferenceTime;
             count += 1;
             int fps = (int) 1e3/ inferenceTime;
-
-            cv::putText(rframe, std::to_string(fps), cv::Point(20, 70), cv::FONT_HERSHEY_PLAIN, 3, cv::Scalar(0, 196, 255), 2);
         #endif
 
-        cv::imshow("Hand detector", rframe);
-
-        if (cv::waitKey(10) == 27)
-            break;
+        // 그리기와 화면 출력은 렌더 스레드에서 (캡처한 프레임은 수정하지 않음)
+        if (renderer.isEnabled()) {
+            hand::RenderFrame render;
+            render.frame = rframe;
+            render.landmarks = landmarks;
+            #if SKIN_TRACKING
+                if (skinTracker.isTracking())
+                    render.roi = skinTracker.getHandRoi();
+            #endif
+            #if SHOW_FPS
+                render.lines.push_back(std::to_string(fps));
+            #endif
+            #if GESTURE_ENGINE
+                if (gestureDisplay > 0) {
+                    gestureDisplay--;
+                    render.lines.push_back(gestureText);
+                }
+            #endif
+            renderer.post(std::move(render));
+        }
     }
+    renderer.stop();
 
     #if SHOW_FPS
         std::cout << "Average inference time: " << sum / count << "ms " << std::endl;
     #endif
 
+    #if FLOW_INTERPOLATION
+        auto flowStats = flow.getStats();
+        std::cout << "Optical flow: " << flowStats.propagated << " frames propagated, " 
+                  << flowStats.resets << " neural results, " 
+                  << flowStats.resyncs << " resyncs" << std::endl;
+    #endif
+
+    #if GESTURE_ENGINE
+        gestures.stop();
+        auto gestureStats = gestures.getStats();
+        std::cout << "Gestures: " << gestureStats.events << " events from " << gestureStats.samples << " samples"
+                  << " (dropped " << gestureStats.droppedSamples << " samples, " 
+                  << gestureStats.droppedEvents << " events)" << std::endl;
+    #endif
+
+    #if GST_CAPTURE
+        auto gstStats = cap.getStats();
+        std::cout << "GStreamer: " << gstStats.delivered << "/" << gstStats.received << " samples read"
+                  << " (dropped " << gstStats.dropped << ", max queue " << gstStats.maxQueueDepth << ")"
+                  << ", latency: " << gstStats.avgLatencyMs << "ms" << std::endl;
+    #endif
+
+    #if MOTION_GATE
+        auto gateStats = gate.getStats();
+        std::cout << "Motion gate: " << gateStats.skipped << "/" << gateStats.frames << " frames skipped"
+                  << " (gate " << gateStats.avgGateMs << "ms/frame)"
+                  << ", saved " << gateStats.savedMs / 1e3 << "s of inference" << std::endl;
+    #endif
+
+    #if !HEADLESS
+        auto renderStats = renderer.getStats();
+        std::cout << "Renderer: " << renderStats.displayed << "/" << renderStats.posted << " frames displayed"
+                  << " (" << renderStats.replaced << " replaced)" << std::endl;
+    #endif
+
     cap.release();
-    cv::destroyAllWindows();
     return 0;
 }
\ No newline at end of file
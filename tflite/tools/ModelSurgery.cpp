@@ -0,0 +1,433 @@
+/*
+Offline edits of the bundled .tflite models (runs on the host, only needs
+the flatbuffers and schema headers of include/).
+
+Usage:
+    model_surgery palm-decode <in.tflite> <out.tflite> [score_threshold] [iou_threshold] [max_detections]
+        Append the HandPalmDecode custom op (src/PalmDecodeOp.hpp) after the
+        raw boxes and scores of the palm detection model, so the model only
+        outputs the final detections and their count.
+
+    model_surgery preprocess <in.tflite> <out.tflite> [width height]
+        Prepend the preprocessing of ModelLoader to a palm or landmark model:
+        the new input takes uint8 BGR pixels of width x height (default: the
+        model input size), then RESIZE_BILINEAR (only if the size differs),
+        GATHER (BGR to RGB), CAST to float and MUL / ADD ((x - 127.5) / 127.5).
+        ModelLoader feeds such models raw bytes (see ModelLoader::isRawInput()).
+
+    model_surgery ops [--micro] <out.hpp> <model.tflite>...
+        Write registerSelectedOps(), which adds to a MutableOpResolver the
+        builtin ops (and versions) used by the models, nothing else. Fails if
+        a file is not a valid model, so a missing op never surfaces at runtime.
+        Used by the SELECTED_OPS build option (see InterpreterBackend.cpp).
+        With --micro, the same for a tflite::MicroMutableOpResolver of exactly
+        that many ops (SelectedMicroOpResolver, see MicroBackend.cpp).
+*/
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flatbuffers/flexbuffers.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+#include "../src/DetectionPostProcess.hpp"
+#include "../src/PalmDecodeOp.hpp"
+
+#define PREPROCESS_MEAN     127.5f  // Same as INPUT_NORM_MEAN / INPUT_NORM_STD of ModelLoader
+#define PREPROCESS_STD      127.5f
+
+
+/*
+Helper functions
+*/
+/*
+Unpack the model in path, exit on failure
+*/
+static std::unique_ptr<tflite::ModelT> __readModel(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    flatbuffers::Verifier verifier(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+    if (bytes.empty() || tflite::VerifyModelBuffer(verifier) == false) {
+        std::cerr << "Fail to read a tflite model from file: " << path << std::endl;
+        std::exit(1);
+    }
+    return std::unique_ptr<tflite::ModelT>(tflite::GetModel(bytes.data())->UnPack());
+}
+
+
+static void __writeModel(const tflite::ModelT& model, const std::string& path) {
+    flatbuffers::FlatBufferBuilder builder;
+    builder.Finish(tflite::Model::Pack(builder, &model), tflite::ModelIdentifier());
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(builder.GetBufferPointer()), builder.GetSize());
+    if (file.good() == false) {
+        std::cerr << "Fail to write model to file: " << path << std::endl;
+        std::exit(1);
+    }
+}
+
+
+/*
+Index of the operator code of custom op name, added if the model does not use it yet
+*/
+static int __customOpCode(tflite::ModelT& model, const std::string& name) {
+    for (int i = 0; i < (int)model.operator_codes.size(); ++i) {
+        const auto& code = model.operator_codes[i];
+        if (code->builtin_code == tflite::BuiltinOperator_CUSTOM && code->custom_code == name)
+            return i;
+    }
+
+    std::unique_ptr<tflite::OperatorCodeT> code(new tflite::OperatorCodeT());
+    code->builtin_code = tflite::BuiltinOperator_CUSTOM;
+    code->deprecated_builtin_code = tflite::BuiltinOperator_CUSTOM;
+    code->custom_code = name;
+    code->version = 1;
+    model.operator_codes.push_back(std::move(code));
+    return model.operator_codes.size() - 1;
+}
+
+
+/*
+Index of the operator code of builtin op, added if the model does not use it yet
+*/
+static int __builtinOpCode(tflite::ModelT& model, tflite::BuiltinOperator op, int version = 1) {
+    for (int i = 0; i < (int)model.operator_codes.size(); ++i) {
+        auto& code = model.operator_codes[i];
+        if (std::max((int)code->deprecated_builtin_code, (int)code->builtin_code) == op) {
+            code->version = std::max(code->version, version);
+            return i;
+        }
+    }
+
+    std::unique_ptr<tflite::OperatorCodeT> code(new tflite::OperatorCodeT());
+    code->builtin_code = op;
+    code->deprecated_builtin_code = std::min((int)op, (int)tflite::BuiltinOperator_PLACEHOLDER_FOR_GREATER_OP_CODES);
+    code->version = version;
+    model.operator_codes.push_back(std::move(code));
+    return model.operator_codes.size() - 1;
+}
+
+
+/*
+Index of a buffer without data, for tensors computed at run time (by convention buffer 0)
+*/
+static int __emptyBuffer(tflite::ModelT& model) {
+    if (model.buffers.empty() == false && model.buffers[0]->data.empty())
+        return 0;
+
+    model.buffers.push_back(std::unique_ptr<tflite::BufferT>(new tflite::BufferT()));
+    return model.buffers.size() - 1;
+}
+
+
+/*
+Append a tensor computed at run time
+*/
+static int __addTensor(tflite::ModelT& model, tflite::SubGraphT& graph, const std::string& name,
+                       const std::vector<int>& shape, tflite::TensorType type = tflite::TensorType_FLOAT32) {
+    std::unique_ptr<tflite::TensorT> tensor(new tflite::TensorT());
+    tensor->name = name;
+    tensor->shape = shape;
+    tensor->type = type;
+    tensor->buffer = __emptyBuffer(model);
+    graph.tensors.push_back(std::move(tensor));
+    return graph.tensors.size() - 1;
+}
+
+
+/*
+Append a constant tensor holding values
+*/
+template <class T>
+static int __addConstant(tflite::ModelT& model, tflite::SubGraphT& graph, const std::string& name,
+                         const std::vector<T>& values, tflite::TensorType type) {
+    std::unique_ptr<tflite::BufferT> buffer(new tflite::BufferT());
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values.data());
+    buffer->data.assign(bytes, bytes + values.size() * sizeof(T));
+    model.buffers.push_back(std::move(buffer));
+
+    std::unique_ptr<tflite::TensorT> tensor(new tflite::TensorT());
+    tensor->name = name;
+    tensor->shape = {(int)values.size()};
+    tensor->type = type;
+    tensor->buffer = model.buffers.size() - 1;
+    graph.tensors.push_back(std::move(tensor));
+    return graph.tensors.size() - 1;
+}
+
+
+/*
+Build an operator of builtin op code from inputs to outputs
+*/
+static std::unique_ptr<tflite::OperatorT> __makeOperator(int opcode, const std::vector<int>& inputs,
+                                                         const std::vector<int>& outputs) {
+    std::unique_ptr<tflite::OperatorT> op(new tflite::OperatorT());
+    op->opcode_index = opcode;
+    op->inputs = inputs;
+    op->outputs = outputs;
+    return op;
+}
+
+
+static int __palmDecode(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " palm-decode <in.tflite> <out.tflite>"
+                  << " [score_threshold] [iou_threshold] [max_detections]" << std::endl;
+        return 1;
+    }
+    float scoreThreshold = argc > 4 ? std::stof(argv[4]) : MIN_THRESHOLD;
+    float iouThreshold = argc > 5 ? std::stof(argv[5]) : PALM_DECODE_IOU_THRESHOLD;
+    int maxDetections = argc > 6 ? std::stoi(argv[6]) : PALM_DECODE_MAX_DETECTIONS;
+
+    auto model = __readModel(argv[2]);
+    tflite::SubGraphT& graph = *model->subgraphs[0];
+
+    /*
+    The raw outputs: boxes [1, NUM_BOXES, NUM_COORD] then scores [1, NUM_BOXES, 1]
+    */
+    if (graph.outputs.size() != 2
+     || graph.tensors[graph.outputs[0]]->shape != std::vector<int>({1, NUM_BOXES, NUM_COORD})) {
+        std::cerr << "Model does not end with the raw palm boxes and scores (already decoded?)." << std::endl;
+        return 1;
+    }
+
+    flexbuffers::Builder options;
+    options.Map([&]() {
+        options.Float("score_threshold", scoreThreshold);
+        options.Float("iou_threshold", iouThreshold);
+        options.Int("max_detections", maxDetections);
+    });
+    options.Finish();
+
+    std::unique_ptr<tflite::OperatorT> op(new tflite::OperatorT());
+    op->opcode_index = __customOpCode(*model, PALM_DECODE_OP_NAME);
+    op->inputs = graph.outputs;
+    op->outputs = {
+        __addTensor(*model, graph, "palm_detections", {1, maxDetections, PALM_DECODE_NUM_VALUES}),
+        __addTensor(*model, graph, "palm_count", {1})
+    };
+    op->custom_options = options.GetBuffer();
+    op->custom_options_format = tflite::CustomOptionsFormat_FLEXBUFFERS;
+
+    graph.outputs = op->outputs;
+    graph.operators.push_back(std::move(op));
+
+    /*
+    Signatures still name the raw outputs
+    */
+    model->signature_defs.clear();
+
+    __writeModel(*model, argv[3]);
+    std::cout << "Appended " << PALM_DECODE_OP_NAME << " (score > " << scoreThreshold << ", iou " << iouThreshold
+              << ", max " << maxDetections << "): " << argv[3] << std::endl;
+    return 0;
+}
+
+
+static int __preprocess(int argc, char* argv[]) {
+    if (argc != 4 && argc != 6) {
+        std::cerr << "Usage: " << argv[0] << " preprocess <in.tflite> <out.tflite> [width height]" << std::endl;
+        return 1;
+    }
+
+    auto model = __readModel(argv[2]);
+    tflite::SubGraphT& graph = *model->subgraphs[0];
+
+    const int modelInput = graph.inputs[0];
+    const std::vector<int> shape = graph.tensors[modelInput]->shape;
+    if (graph.inputs.size() != 1 || shape.size() != 4 || shape[3] != 3
+     || graph.tensors[modelInput]->type != tflite::TensorType_FLOAT32) {
+        std::cerr << "Model input is not one float [1, height, width, 3] image (already done?)." << std::endl;
+        return 1;
+    }
+    const int height = argc == 6 ? std::stoi(argv[5]) : shape[1];
+    const int width = argc == 6 ? std::stoi(argv[4]) : shape[2];
+
+    /*
+    Operators are built in run order, then put in front of the graph
+    */
+    std::vector<std::unique_ptr<tflite::OperatorT>> ops;
+    int input = __addTensor(*model, graph, "input_bgr_uint8", {1, height, width, 3}, tflite::TensorType_UINT8);
+    int current = input;
+
+    if (height != shape[1] || width != shape[2]) {
+        int resized = __addTensor(*model, graph, "input_resized", {1, shape[1], shape[2], 3}, tflite::TensorType_UINT8);
+        int size = __addConstant<int32_t>(*model, graph, "input_size", {shape[1], shape[2]}, tflite::TensorType_INT32);
+
+        /*
+        Half pixel centers: same sampling as cv::resize (needs version 3 of the op)
+        */
+        auto op = __makeOperator(__builtinOpCode(*model, tflite::BuiltinOperator_RESIZE_BILINEAR, 3),
+                                 {current, size}, {resized});
+        tflite::ResizeBilinearOptionsT options;
+        options.align_corners = false;
+        options.half_pixel_centers = true;
+        op->builtin_options.Set(options);
+        ops.push_back(std::move(op));
+        current = resized;
+    }
+
+    int rgb = __addTensor(*model, graph, "input_rgb_uint8", {1, shape[1], shape[2], 3}, tflite::TensorType_UINT8);
+    int order = __addConstant<int32_t>(*model, graph, "input_channel_order", {2, 1, 0}, tflite::TensorType_INT32);
+    auto gather = __makeOperator(__builtinOpCode(*model, tflite::BuiltinOperator_GATHER), {current, order}, {rgb});
+    tflite::GatherOptionsT gatherOptions;
+    gatherOptions.axis = 3;
+    gather->builtin_options.Set(gatherOptions);
+    ops.push_back(std::move(gather));
+
+    int floats = __addTensor(*model, graph, "input_float", {1, shape[1], shape[2], 3});
+    auto cast = __makeOperator(__builtinOpCode(*model, tflite::BuiltinOperator_CAST), {rgb}, {floats});
+    tflite::CastOptionsT castOptions;
+    castOptions.in_data_type = tflite::TensorType_UINT8;
+    castOptions.out_data_type = tflite::TensorType_FLOAT32;
+    cast->builtin_options.Set(castOptions);
+    ops.push_back(std::move(cast));
+
+    /*
+    (x - mean) / std == x * (1 / std) + (-mean / std), written to the old model input
+    */
+    int scaled = __addTensor(*model, graph, "input_scaled", {1, shape[1], shape[2], 3});
+    int scale = __addConstant<float>(*model, graph, "input_scale", {1.f / PREPROCESS_STD}, tflite::TensorType_FLOAT32);
+    int offset = __addConstant<float>(*model, graph, "input_offset", {-PREPROCESS_MEAN / PREPROCESS_STD},
+                                      tflite::TensorType_FLOAT32);
+
+    auto mul = __makeOperator(__builtinOpCode(*model, tflite::BuiltinOperator_MUL), {floats, scale}, {scaled});
+    mul->builtin_options.Set(tflite::MulOptionsT());
+    ops.push_back(std::move(mul));
+
+    auto add = __makeOperator(__builtinOpCode(*model, tflite::BuiltinOperator_ADD), {scaled, offset}, {modelInput});
+    add->builtin_options.Set(tflite::AddOptionsT());
+    ops.push_back(std::move(add));
+
+    graph.operators.insert(graph.operators.begin(),
+                           std::make_move_iterator(ops.begin()), std::make_move_iterator(ops.end()));
+    graph.inputs = {input};
+
+    /*
+    Signatures still name the float input
+    */
+    model->signature_defs.clear();
+
+    __writeModel(*model, argv[3]);
+    std::cout << "Prepended preprocessing (uint8 BGR " << width << "x" << height << " to float "
+              << shape[2] << "x" << shape[1] << "): " << argv[3] << std::endl;
+    return 0;
+}
+
+
+/*
+Name of the MicroMutableOpResolver method registering a builtin op (CONV_2D -> AddConv2D)
+*/
+static std::string __microAddName(const std::string& op) {
+    std::string name = "Add";
+    bool first = true;
+    for (char c : op) {
+        if (c == '_') {
+            first = true;
+            continue;
+        }
+        name += first || std::isdigit((unsigned char)name.back()) ? c : (char)std::tolower(c);
+        first = false;
+    }
+    return name;
+}
+
+
+static int __ops(int argc, char* argv[]) {
+    bool micro = argc > 2 && std::string(argv[2]) == "--micro";
+    int out = micro ? 3 : 2;
+    if (argc < out + 2) {
+        std::cerr << "Usage: " << argv[0] << " ops [--micro] <out.hpp> <model.tflite>..." << std::endl;
+        return 1;
+    }
+
+    /*
+    Op name -> {min version, max version} over every operator of every model
+    */
+    std::map<std::string, std::pair<int, int>> ops;
+    for (int i = out + 1; i < argc; ++i) {
+        auto model = __readModel(argv[i]);
+        for (const auto& graph : model->subgraphs) {
+            for (const auto& op : graph->operators) {
+                const auto& code = model->operator_codes[op->opcode_index];
+                int builtin = std::max((int)code->deprecated_builtin_code, (int)code->builtin_code);
+                if (builtin == tflite::BuiltinOperator_CUSTOM)
+                    continue; // Custom ops are registered by the backend
+
+                std::string name = tflite::EnumNameBuiltinOperator((tflite::BuiltinOperator)builtin);
+                auto found = ops.emplace(name, std::make_pair(code->version, code->version));
+                found.first->second.first = std::min(found.first->second.first, code->version);
+                found.first->second.second = std::max(found.first->second.second, code->version);
+            }
+        }
+    }
+
+    std::ofstream file(argv[out]);
+    file << "/*\nGenerated by: model_surgery ops" << (micro ? " --micro" : "") << " (do not edit)\nModels:\n";
+    for (int i = out + 1; i < argc; ++i) {
+        file << "    " << argv[i] << "\n";
+    }
+
+    if (micro) {
+        /*
+        TFLM kernels are not versioned. An op without an Add method fails the build.
+        */
+        file << "*/\n#ifndef SELECTEDMICROOPS_H\n#define SELECTEDMICROOPS_H\n\n"
+             << "#include \"tensorflow/lite/micro/micro_mutable_op_resolver.h\"\n\n"
+             << "namespace hand {\n\n"
+             << "    using SelectedMicroOpResolver = tflite::MicroMutableOpResolver<" << ops.size() << ">;\n\n"
+             << "    inline void registerSelectedOps(SelectedMicroOpResolver& resolver) {\n";
+        for (const auto& op : ops) {
+            file << "        resolver." << __microAddName(op.first) << "();\n";
+        }
+        file << "    }\n}\n\n#endif // SELECTEDMICROOPS_H\n";
+    }
+    else {
+        file << "*/\n#ifndef SELECTEDOPS_H\n#define SELECTEDOPS_H\n\n"
+             << "#include \"tensorflow/lite/mutable_op_resolver.h\"\n\n"
+             << "namespace tflite {\n    namespace ops {\n        namespace builtin {\n";
+        for (const auto& op : ops) {
+            file << "            TfLiteRegistration* Register_" << op.first << "();\n";
+        }
+        file << "        }\n    }\n}\n\n"
+             << "namespace hand {\n\n"
+             << "    inline void registerSelectedOps(tflite::MutableOpResolver& resolver) {\n";
+        for (const auto& op : ops) {
+            file << "        resolver.AddBuiltin(tflite::BuiltinOperator_" << op.first
+                 << ", tflite::ops::builtin::Register_" << op.first << "(), "
+                 << op.second.first << ", " << op.second.second << ");\n";
+        }
+        file << "    }\n}\n\n#endif // SELECTEDOPS_H\n";
+    }
+
+    if (file.good() == false) {
+        std::cerr << "Fail to write file: " << argv[out] << std::endl;
+        return 1;
+    }
+    std::cout << ops.size() << " builtin ops used by " << argc - out - 1 << " models: " << argv[out] << std::endl;
+    return 0;
+}
+
+
+int main(int argc, char* argv[]) {
+    std::string command = argc > 1 ? argv[1] : "";
+    if (command == "palm-decode")
+        return __palmDecode(argc, argv);
+    if (command == "preprocess")
+        return __preprocess(argc, argv);
+    if (command == "ops")
+        return __ops(argc, argv);
+
+    std::cerr << "Usage: " << argv[0] << " palm-decode <in.tflite> <out.tflite> [...]" << std::endl
+              << "       " << argv[0] << " preprocess <in.tflite> <out.tflite> [width height]" << std::endl
+              << "       " << argv[0] << " ops [--micro] <out.hpp> <model.tflite>..." << std::endl;
+    return 1;
+}